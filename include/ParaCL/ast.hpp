@@ -1,6 +1,10 @@
 #pragma once
 
 #include "node.hpp"
+#include "vm/vm.hpp"
+#include "vm/c_emitter.hpp"
+
+#include <fstream>
 
 namespace paracl {
     inline void execute_ast(node_scope_t* root, execute_params_t& params) {
@@ -10,8 +14,10 @@ namespace paracl {
         params.insert_statement(root);
 
         while (!statements.empty()) {
+            params.collect_garbage();
             state = execute_state_e::PROCESS;
             node_interpretable_t* statement = statements.top();
+            params.begin_statement();
             statement->execute(params);
 
             switch (state) {
@@ -23,6 +29,11 @@ namespace paracl {
                     params.on_return();
                     break;
                 }
+                case execute_state_e::TAIL_CALL: {
+                    params.unwind_call();
+                    params.tail_function->execute_tail(params);
+                    break;
+                }
                 default: break;
             }
         }
@@ -33,15 +44,49 @@ namespace paracl {
         buffer_t buffer_;
 
         void execute(environments_t& env) {
-            if (root_) {
-                buffer_t execution_buffer;
-                execute_params_t execute_params{&execution_buffer, env.os, env.is, env.program_str};
-                execute_ast(root_, execute_params);
-            } else {
+            if (!root_)
                 throw error_t{str_red("execute by nullptr")};
+
+            switch (env.engine) {
+                case engine_e::AST: execute_tree(env); break;
+                case engine_e::VM:  execute_vm  (env); break;
+                default: throw error_t{str_red("execute by unknown engine")};
             }
         }
 
+        void execute_tree(environments_t& env) {
+            buffer_t execution_buffer{env.resource};
+            execute_params_t execute_params{&execution_buffer, env.os, env.is, env.program_str, env.resource};
+            execute_ast(root_, execute_params);
+        }
+
+        void compile(bytecode_t& code, environments_t& env) {
+            compile_params_t compile_params{&code, env.program_str};
+            root_->compile(compile_params);
+            code.emit(opcode_e::HALT, root_);
+        }
+
+        void execute_vm(environments_t& env) {
+            bytecode_t code;
+            compile(code, env);
+
+            vm_t vm{code, env};
+            vm.execute();
+        }
+
+        void emit_c(environments_t& env, const std::string& file_name) {
+            if (!root_)
+                throw error_t{str_red("emit by nullptr")};
+
+            bytecode_t code;
+            compile(code, env);
+
+            std::ofstream file{file_name};
+            if (!file.is_open())
+                throw error_t{str_red("can't open file: " + file_name)};
+            c_emitter_t{code, env.program_str}.emit(file);
+        }
+
         void analyze(environments_t& env) {
             if (root_) {
                 buffer_t copy_buffer;
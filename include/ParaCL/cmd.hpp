@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hpp"
+#include "environments.hpp"
 #include <string>
 #include <memory>
 #include <unordered_map>
@@ -96,6 +97,96 @@ namespace paracl {
         }
     };
 
+    class cmd_engine_t final : public cmd_flag_t {
+        using cmd_flag_t::is_setted_;
+        engine_e value_ = engine_e::AST;
+
+        static constexpr std::string_view prefix_ = "--engine=";
+
+    public:
+        cmd_engine_t() : cmd_flag_t("--engine=<ast|vm>", false, true, "select execution engine") {}
+        engine_e value() const noexcept { return value_; }
+        using cmd_flag_t::name;
+
+        bool parse(std::string_view flag) override {
+            if (flag.substr(0, prefix_.size()) != prefix_)
+                return false;
+
+            std::string_view engine = flag.substr(prefix_.size());
+            if (engine == "ast")
+                value_ = engine_e::AST;
+            else if (engine == "vm")
+                value_ = engine_e::VM;
+            else
+                throw error_t{str_red("unknown engine: " + std::string(engine))};
+
+            is_setted_ = true;
+            return is_setted_;
+        }
+    };
+
+    class cmd_is_jit_t final : public cmd_flag_t {
+        using cmd_flag_t::is_setted_;
+        bool value_ = false;
+
+    public:
+        cmd_is_jit_t() : cmd_flag_t("--jit", false, true, "compile hot code of vm to native") {}
+        bool value() const noexcept { return value_; }
+        using cmd_flag_t::name;
+
+        bool parse(std::string_view flag) override {
+            if (flag == name()) {
+                value_ = true;
+                is_setted_ = true;
+            }
+            return is_setted_;
+        }
+    };
+
+    class cmd_emit_c_t final : public cmd_flag_t {
+        using cmd_flag_t::is_setted_;
+        std::string value_;
+        bool is_waiting_ = false; // name of file is the next token
+
+        static constexpr std::string_view prefix_ = "--emit-c";
+
+    public:
+        cmd_emit_c_t() : cmd_flag_t("--emit-c <out_file>", false, true, "translate program to c++ instead of execution") {}
+        const std::string& value() const { return value_; }
+        bool is_waiting() const noexcept { return is_waiting_; }
+        using cmd_flag_t::name;
+
+        bool parse(std::string_view flag) override {
+            if (is_waiting_) {
+                value_ = flag;
+                is_waiting_ = false;
+                is_setted_ = true;
+                return is_setted_;
+            }
+
+            is_waiting_ = (flag == prefix_);
+            return is_waiting_;
+        }
+    };
+
+    class cmd_is_compile_t final : public cmd_flag_t {
+        using cmd_flag_t::is_setted_;
+        bool value_ = false;
+
+    public:
+        cmd_is_compile_t() : cmd_flag_t("--compile", false, true, "compile emitted c++ by $CXX") {}
+        bool value() const noexcept { return value_; }
+        using cmd_flag_t::name;
+
+        bool parse(std::string_view flag) override {
+            if (flag == name()) {
+                value_ = true;
+                is_setted_ = true;
+            }
+            return is_setted_;
+        }
+    };
+
     class cmd_flags_t {
     protected:
         std::pair<int, int> cnt_flags_;
@@ -116,6 +207,13 @@ namespace paracl {
 
     protected:
         void parse_token(std::string_view cmd_flag) {
+            // flag waiting for its value takes token before others
+            for (auto& flag_ : flags_) {
+                auto emit_c = dynamic_cast<cmd_emit_c_t*>(flag_.second.get());
+                if (emit_c && emit_c->is_waiting() && emit_c->parse(cmd_flag))
+                    return;
+            }
+
             for (auto& flag_ : flags_) {
                 cmd_flag_t& flag = *flag_.second.get();
                 if (!flag.is_titeled() || flag.is_setted())
@@ -149,6 +247,18 @@ namespace paracl {
             std::unique_ptr<cmd_is_help_t> is_help = std::make_unique<cmd_is_help_t>();
             flags_.emplace(is_help.get()->name(), std::move(is_help));
 
+            std::unique_ptr<cmd_engine_t> engine = std::make_unique<cmd_engine_t>();
+            flags_.emplace(engine.get()->name(), std::move(engine));
+
+            std::unique_ptr<cmd_is_jit_t> is_jit = std::make_unique<cmd_is_jit_t>();
+            flags_.emplace(is_jit.get()->name(), std::move(is_jit));
+
+            std::unique_ptr<cmd_emit_c_t> emit_c = std::make_unique<cmd_emit_c_t>();
+            flags_.emplace(emit_c.get()->name(), std::move(emit_c));
+
+            std::unique_ptr<cmd_is_compile_t> is_compile = std::make_unique<cmd_is_compile_t>();
+            flags_.emplace(is_compile.get()->name(), std::move(is_compile));
+
             cnt_flags_ = get_cnt_flags();
         }
 
@@ -175,6 +285,11 @@ namespace paracl {
         using cmd_flags_t::cnt_flags_;
         using cmd_flags_t::flags_;
 
+        cmd_emit_c_t* emit_c_flag() const {
+            cmd_flag_t* flag = flags_.find("--emit-c <out_file>")->second.get();
+            return static_cast<cmd_emit_c_t*>(flag);
+        }
+
     public:
         void parse(int argc, char* argv[]) {
             if (argc < cnt_flags_.first)
@@ -185,6 +300,13 @@ namespace paracl {
 
             lookup_print_help(std::cout);
             cmd_flags_t::check_valid();
+
+            if (emit_c_flag()->is_waiting())
+                throw error_t{str_red("missing name of file after --emit-c")};
+            if (is_jit() && engine() != engine_e::VM)
+                throw error_t{str_red("--jit is used only with --engine=vm")};
+            if (is_compile() && !is_emit_c())
+                throw error_t{str_red("--compile is used only with --emit-c")};
         }
 
         const std::string& program_file() const {
@@ -196,6 +318,24 @@ namespace paracl {
             cmd_flag_t* flag = flags_.find("--analyze_only")->second.get();
             return static_cast<cmd_is_analyze_only_t*>(flag)->value();
         }
+
+        engine_e engine() const noexcept {
+            cmd_flag_t* flag = flags_.find("--engine=<ast|vm>")->second.get();
+            return static_cast<cmd_engine_t*>(flag)->value();
+        }
+        bool is_emit_c() const noexcept { return emit_c_flag()->is_setted(); }
+        const std::string& emit_c_file() const { return emit_c_flag()->value(); }
+
+        bool is_jit() const noexcept {
+            cmd_flag_t* flag = flags_.find("--jit")->second.get();
+            return static_cast<cmd_is_jit_t*>(flag)->value();
+        }
+
+        bool is_compile() const noexcept {
+            cmd_flag_t* flag = flags_.find("--compile")->second.get();
+            return static_cast<cmd_is_compile_t*>(flag)->value();
+        }
+
         std::ostream& lookup_print_help(std::ostream& os) const {
             cmd_flag_t* flag = flags_.find("--help")->second.get();
             bool is_help = static_cast<cmd_is_help_t*>(flag)->value();
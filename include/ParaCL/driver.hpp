@@ -14,15 +14,9 @@ namespace yy {
 
     /* ----------------------------------------------------- */
 
+    // location of node starts where its first token starts
     inline location_t make_loc(const location& loc, int len) {
-        std::stringstream ss;
-        ss << loc;
-        std::string loc_str = ss.str();
-
-        size_t dot_location = loc_str.find('.');
-        int row = stoi(loc_str.substr(0, dot_location));
-        int col = stoi(loc_str.substr(dot_location + 1));
-        return {row - 1, col, len};
+        return {static_cast<int>(loc.begin.line) - 1, static_cast<int>(loc.begin.column), len};
     };
 
     /* ----------------------------------------------------- */
@@ -69,6 +63,8 @@ namespace yy {
             return buf_->add_node<NodeT>(make_loc(loc, len), std::forward<ArgsT>(args)...);
         }
 
+        std::string_view intern(std::string_view name) { return buf_->intern(name); }
+
         bool parse(const std::string& file_name, buffer_t& buf,
                    node_scope_t*& root, std::string_view program_str) {
             program_str_ = program_str;
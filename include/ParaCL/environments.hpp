@@ -1,12 +1,23 @@
 #pragma once
 
 #include <iostream>
+#include <memory_resource>
 #include <string>
 
 namespace paracl {
+    enum class engine_e {
+        AST,
+        VM
+    };
+
     struct environments_t final {
         std::ostream* os = nullptr;
         std::istream* is = nullptr;
         std::string_view program_str = {};
+        engine_e engine = engine_e::AST;
+        bool is_jit = false;
+
+        // memory of tree interpreter run: its nodes and containers
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource();
     };
 }
\ No newline at end of file
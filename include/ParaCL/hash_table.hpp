@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace paracl {
+    // open addressing with linear probing by integer keys. capacity is power of 2 and at most
+    // half of it is used, so probe sequences stay short
+    template <typename ValueT>
+    class hash_table_t final {
+        struct slot_t final {
+            int    key     = 0;
+            bool   is_used = false;
+            ValueT value{};
+        };
+
+        std::pmr::vector<slot_t> slots_;
+        int size_  = 0;
+        int shift_ = 0;
+
+        static constexpr int min_capacity = 8;
+
+    private:
+        // the highest bits of product with odd constant mix all bits of key
+        size_t index(int key) const noexcept {
+            return static_cast<uint32_t>(static_cast<uint32_t>(key) * 2654435769u) >> shift_;
+        }
+
+        slot_t& probe(int key) {
+            const size_t mask = slots_.size() - 1;
+            for (size_t i = index(key);; i = (i + 1) & mask) {
+                slot_t& slot = slots_[i];
+                if (!slot.is_used || slot.key == key)
+                    return slot;
+            }
+        }
+
+        void grow() {
+            std::pmr::vector<slot_t> old = std::move(slots_);
+            const size_t capacity = old.empty() ? min_capacity : 2 * old.size();
+            std::destroy_at(&slots_);
+            std::construct_at(&slots_, capacity, old.get_allocator());
+            shift_ = 32 - std::countr_zero(capacity);
+
+            for (slot_t& slot : old)
+                if (slot.is_used)
+                    probe(slot.key) = std::move(slot);
+        }
+
+    public:
+        explicit hash_table_t(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : slots_(resource) {}
+
+        int size() const noexcept { return size_; }
+
+        ValueT* find(int key) {
+            if (slots_.empty())
+                return nullptr;
+            slot_t& slot = probe(key);
+            return slot.is_used ? &slot.value : nullptr;
+        }
+
+        // new key gets default value
+        ValueT& operator[](int key) {
+            if (ValueT* value = find(key))
+                return *value;
+
+            if (2 * (size_ + 1) > static_cast<int>(slots_.size()))
+                grow();
+            slot_t& slot = probe(key);
+            slot.key     = key;
+            slot.is_used = true;
+            ++size_;
+            return slot.value;
+        }
+
+        // pairs in ascending order of keys, so output doesn't depend on capacity
+        std::vector<std::pair<int, ValueT>> sorted() const {
+            std::vector<std::pair<int, ValueT>> pairs;
+            pairs.reserve(size_);
+            for (const slot_t& slot : slots_)
+                if (slot.is_used)
+                    pairs.emplace_back(slot.key, slot.value);
+            std::ranges::sort(pairs, {}, &std::pair<int, ValueT>::first);
+            return pairs;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <memory_resource>
+#include <vector>
+
+namespace paracl {
+    // elements of repeat are its value until they are written, pages of them are materialized
+    // on first write, so array of any size is created at once
+    template <typename ElemT>
+    class lazy_values_t final {
+        static constexpr int page_size = 256;
+        using page_t = std::pmr::vector<ElemT>;
+
+        int   size_ = 0;
+        ElemT value_{};
+        std::pmr::vector<page_t> pages_;
+
+    public:
+        lazy_values_t() = default;
+        lazy_values_t(int size, const ElemT& value,
+                      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : size_(size), value_(value), pages_(resource) {}
+
+        int  size()  const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        // element is materialized only for write, untouched ones share value of repeat on read
+        ElemT& at(int index, bool is_write) {
+            size_t page = index / page_size;
+            if (page < pages_.size() && !pages_[page].empty())
+                return pages_[page][index % page_size];
+            if (!is_write)
+                return value_;
+
+            if (page >= pages_.size())
+                pages_.resize(page + 1);
+            pages_[page].assign(std::min(page_size, size_ - static_cast<int>(page) * page_size), value_);
+            return pages_[page][index % page_size];
+        }
+
+        const ElemT& get(int index) const {
+            size_t page = index / page_size;
+            if (page < pages_.size() && !pages_[page].empty())
+                return pages_[page][index % page_size];
+            return value_;
+        }
+
+        // value of untouched elements and every materialized one
+        template <typename FuncT>
+        void for_each_distinct(FuncT&& func) {
+            func(value_);
+            for (page_t& page : pages_)
+                std::ranges::for_each(page, func);
+        }
+    };
+}
\ No newline at end of file
@@ -9,4 +9,6 @@
 #include "ParaCL/nodes/fork.hpp"
 #include "ParaCL/nodes/loop.hpp"
 #include "ParaCL/nodes/print.hpp"
+#include "ParaCL/nodes/slice.hpp"
+#include "ParaCL/nodes/array_builtin.hpp"
 #include "ParaCL/nodes/un_op.hpp"
\ No newline at end of file
@@ -1,23 +1,82 @@
 #pragma once
 
+#include "ParaCL/lazy_values.hpp"
 #include "ParaCL/nodes/common.hpp"
+#include "ParaCL/simd.hpp"
 
 namespace paracl {
+    // values of execution take memory of run
+    using execute_values_t = std::pmr::vector<execute_t>;
+
+    inline execute_values_t make_values(execute_params_t& params) { return execute_values_t{params.resource}; }
+    inline std::vector<analyze_t> make_values(analyze_params_t& params) { return {}; }
+
+    /* ----------------------------------------------------- */
+
+    inline lazy_values_t<execute_t> make_lazy_values(int size, const execute_t& value, execute_params_t& params) {
+        return {size, value, params.resource};
+    }
+
+    inline lazy_values_t<analyze_t> make_lazy_values(int size, const analyze_t& value, analyze_params_t& params) {
+        return {size, value};
+    }
+
+    /* ----------------------------------------------------- */
+
+    // integers of array, which analysis proved to be rectangular, one after another in row-major order.
+    // arrays of its dimensions are views over them, views of rows are made on first access
+    struct dense_t final : public node_t,
+                           public heap_node_t {
+        std::pmr::vector<int> elems;
+        std::pmr::vector<int> shape;
+        std::pmr::vector<int> strides;
+        bool is_rectangular = true; // false after nested array is replaced or leaves storage
+
+        dense_t(std::pmr::memory_resource* resource) : elems(resource), shape(resource), strides(resource) {}
+
+        int rank() const noexcept { return shape.size(); }
+
+        // count of integers in view, which starts at dimension dim
+        int count(int dim) const noexcept { return shape[dim] * strides[dim]; }
+
+        void set_strides() {
+            strides.resize(rank());
+            for (int dim = rank() - 1, stride = 1; dim >= 0; stride *= shape[dim--])
+                strides[dim] = stride;
+        }
+
+        size_t count_values() const noexcept override { return elems.size(); }
+
+    protected:
+        void trace(value_heap_t& heap) override {}
+    };
+
+    /* ----------------------------------------------------- */
+
     class node_indexes_t final : public node_t,
                                  public node_loc_t {
         std::vector<node_expression_t*> indexes_;
 
+        // program is analyzed through its copy, so proofs of indexes are kept in parsed node
+        node_indexes_t* origin_ = this;
+        uint8_t proven_   = 0;
+        uint8_t unproven_ = 0; // proof of index failed in some analysis of node
+
+    public:
+        static constexpr size_t max_fixed_depth  = 4;
+        static constexpr int    max_proven_depth = 8;
+        using fixed_indexes_t = std::array<execute_t, max_fixed_depth>;
+
     private:
-        template <typename ElemT, typename FuncT, typename ParamsT>
-        std::vector<ElemT> process_indexes(FuncT&& func, ParamsT& params) const {
-            std::vector<ElemT> indexes(indexes_.size());
+        template <typename ContainerT, typename FuncT, typename ParamsT>
+        ContainerT process_indexes(ContainerT indexes, FuncT&& func, ParamsT& params) const {
+            indexes.resize(indexes_.size());
             for (size_t i = 0, end = indexes_.size(); i < end; ++i) {
-                ElemT result = std::invoke(func, indexes_[i], params);
+                auto result = std::invoke(func, indexes_[i], params);
                 if (!params.is_executed())
                     return {};
                 indexes[i] = result;
             }
-            reverse(indexes.begin(), indexes.end());
             return indexes;
         }
 
@@ -26,22 +85,32 @@ namespace paracl {
 
         void add_index(node_expression_t* index) { assert(index); indexes_.push_back(index); }
 
-        std::vector<execute_t> execute(execute_params_t& params) const {
-            return process_indexes<execute_t>(
+        execute_values_t execute(execute_params_t& params) const {
+            return process_indexes(
+                make_values(params),
                 [](auto index, execute_params_t& params) {
-                    return index->execute(params);
+                    return params.evaluate(index);
                 },
                 params
             );
         }
 
+        // indexes without calls are evaluated into buffer of caller instead of vector
+        std::span<const execute_t> execute(fixed_indexes_t& buffer, execute_params_t& params) const {
+            assert(indexes_.size() <= buffer.size());
+            for (size_t i = 0, end = indexes_.size(); i < end; ++i)
+                buffer[i] = params.evaluate(indexes_[i]);
+            return {buffer.data(), indexes_.size()};
+        }
+
         std::vector<int> execute2ints(execute_params_t& params) const {
-            return process_indexes<int>(
+            return process_indexes(
+                std::vector<int>{},
                 [](auto index, execute_params_t& params) {
-                    execute_t result = index->execute(params);
+                    execute_t result = params.evaluate(index);
                     if (!params.is_executed())
                         return 0;
-                    return static_cast<node_number_t*>(result.value)->get_value();
+                    return result.number;
                 },
                 params
             );
@@ -53,11 +122,11 @@ namespace paracl {
                 [&params](auto index) {
                     analyze_t result = index->analyze(params);
                     expect_types_ne(result.type, node_type_e::ARRAY, index->loc(), params);
+                    expect_types_ne(result.type, node_type_e::MAP,   index->loc(), params);
                     expect_types_ne(result.type, node_type_e::UNDEF, index->loc(), params);
                     return result;
                 }
             );
-            std::reverse(indexes.begin(), indexes.end());
             return indexes;
         }
 
@@ -66,26 +135,79 @@ namespace paracl {
             std::ranges::for_each(indexes_, [node_indexes, &params, parent](auto index) {
                 node_indexes->add_index(index->copy(params, parent));
             });
+            node_indexes->origin_ = origin_;
             return node_indexes;
         }
 
+        // index is proven only if every analysis of it proves it
+        void prove(int depth, const node_t* array, const node_t* index, analyze_params_t& params) {
+            const uint8_t mask = 1 << depth;
+            if (index && params.ranges.prove(array, depth, index, &origin_->unproven_, mask))
+                origin_->proven_ |= mask;
+            else
+                origin_->unproven_ |= mask;
+        }
+
+        uint8_t in_bounds() const noexcept { return proven_ & ~unproven_; }
+
+        bool is_in_bounds(int depth) const noexcept {
+            return depth < max_proven_depth && (in_bounds() >> depth & 1);
+        }
+
+        node_expression_t* operator[](int index) const { return indexes_[index]; }
+
+        void compile(compile_params_t& params) const {
+            std::ranges::for_each(indexes_, [&params](auto index) { index->compile(params); });
+        }
+
         location_t get_index_loc(int index) const {
             return indexes_[index]->loc();
         }
 
-        bool empty() const noexcept { return indexes_.empty(); }
+        bool can_pause() const {
+            return std::ranges::any_of(indexes_, [](auto index) { return index->is_pausable(); });
+        }
+
+        bool   empty() const noexcept { return indexes_.empty(); }
+        size_t size()  const noexcept { return indexes_.size(); }
     };
 
     /* ----------------------------------------------------- */
 
-    using array_execute_data_t = std::pair<std::vector<execute_t>, bool>; // vals, is_in_heap
-    using array_analyze_data_t = std::pair<std::vector<analyze_t>, bool>; // vals, is_in_heap
+    // repeat of not boxed value keeps this value once with count of its copies, repeat of rectangular
+    // array of integers keeps their storage and list of integer literals keeps them instead of values
+    template <typename ValuesT>
+    struct array_data_t final {
+        using values_t = ValuesT;
+
+        ValuesT values;
+        bool is_in_heap = false;
+        int  count_repeat = 0;
+        dense_t* dense = nullptr;
+        std::span<const int> constants = {};
+
+        ValuesT expand() && {
+            assert(!dense && constants.empty());
+            if (count_repeat > 0)
+                values.resize(count_repeat, values.front());
+            return std::move(values);
+        }
+    };
+
+    using array_execute_data_t = array_data_t<execute_values_t>;
+    using array_analyze_data_t = array_data_t<std::vector<analyze_t>>;
     class node_array_values_t {
     public:
         virtual array_execute_data_t execute(execute_params_t& params) const = 0;
         virtual array_analyze_data_t analyze(analyze_params_t& params) = 0;
         virtual int get_level() const = 0;
         virtual node_array_values_t* copy_vals(copy_params_t& params, scope_base_t* parent) const = 0;
+        virtual void compile_vals(compile_params_t& params) const = 0;
+        virtual bool can_pause() const = 0;
+
+        // sizes of array on levels of nesting, which are known to range analysis
+        virtual std::vector<range_bound_t> range_sizes(analyze_params_t& params) const { return {}; }
+
         virtual ~node_array_values_t() = default;
     };
 
@@ -95,9 +217,16 @@ namespace paracl {
                                public node_loc_t {
     public:
         node_array_value_t(const location_t& loc) : node_loc_t(loc) {}
-        virtual void add_value_execute(std::vector<execute_t>& values, execute_params_t& params) const = 0;
+        virtual void add_value_execute(execute_values_t& values, execute_params_t& params) const = 0;
         virtual void add_value_analyze(std::vector<analyze_t>& values, analyze_params_t& params) = 0;
         virtual node_array_value_t* copy_val(copy_params_t& params, scope_base_t* parent) const = 0;
+        virtual void compile_val(compile_params_t& params) const = 0;
+        virtual bool can_pause_val() const = 0;
+
+        // sizes of elements, which value adds to array, on levels of nesting from count of them
+        virtual std::vector<range_bound_t> range_sizes(analyze_params_t& params) const = 0;
+
+        virtual std::optional<int> constant() const { return std::nullopt; }
     };
 
     /* ----------------------------------------------------- */
@@ -109,32 +238,82 @@ namespace paracl {
         node_expression_value_t(const location_t& loc, node_expression_t* value)
         : node_array_value_t(loc), value_(value) { assert(value_); }
 
-        void add_value_execute(std::vector<execute_t>& values, execute_params_t& params) const override {
-            execute_t result = value_->execute(params);
+        void add_value_execute(execute_values_t& values, execute_params_t& params) const override {
+            execute_t result = params.evaluate(value_);
             if (!params.is_executed())
                 return;
 
             values.push_back(result);
         }
 
+        // maps are kept only by variables
         void add_value_analyze(std::vector<analyze_t>& values, analyze_params_t& params) override {
-            values.push_back(value_->analyze(params));
+            analyze_t value = value_->analyze(params);
+            expect_types_ne(value.type, node_type_e::MAP, value_->loc(), params);
+            values.push_back(value);
         }
 
         node_array_value_t* copy_val(copy_params_t& params, scope_base_t* parent) const override {
             return params.buf->add_node<node_expression_value_t>(node_loc_t::loc(), value_->copy(params, parent));
         }
+
+        void compile_val(compile_params_t& params) const override {
+            value_->compile(params);
+            params.emit(opcode_e::ARRAY_APPEND, this);
+        }
+
+        bool can_pause_val() const override { return value_->is_pausable(); }
+
+        std::optional<int> constant() const override { return value_->constant(); }
+
+        std::vector<range_bound_t> range_sizes(analyze_params_t& params) const override {
+            std::vector<range_bound_t> sizes{{nullptr, 1}};
+            std::ranges::copy(value_->range(params).sizes, std::back_inserter(sizes));
+            return sizes;
+        }
     };
 
     /* ----------------------------------------------------- */
 
+    // evaluated array is repeated by its contents instead of copies of its nodes,
+    // into storage of integers if is_dense
+    inline void repeat_array(array_execute_data_t& data, int count, node_type_t* array, bool is_dense,
+                             execute_params_t& params);
+
+    // analysis proves, that array is rectangular and elements of its last level are integers
+    inline bool analyze_dense(const analyze_t& array);
+
+    /* ----------------------------------------------------- */
+
     class node_repeat_values_t : public node_array_value_t,
                                  public node_array_values_t {
         node_expression_t* value_;
         node_expression_t* count_;
         int level_ = 0;
 
+        // program is analyzed through its copy, so proof of storage is kept in parsed node
+        node_repeat_values_t* origin_ = this;
+        bool is_dense_     = false;
+        bool is_not_dense_ = false; // proof failed in some analysis of node
+
     private:
+        void prove_dense(const analyze_t& value) const {
+            if (value.type == node_type_e::ARRAY && analyze_dense(value))
+                origin_->is_dense_ = true;
+            else
+                origin_->is_not_dense_ = true;
+        }
+
+        bool is_dense() const noexcept { return origin_->is_dense_ && !origin_->is_not_dense_; }
+
+        template <typename NodeT>
+        NodeT* copy_impl(copy_params_t& params, scope_base_t* parent) const {
+            auto* node = params.buf->add_node<node_repeat_values_t>(node_loc_t::loc(), value_->copy(params, parent),
+                                                                    count_->copy(params, parent));
+            node->origin_ = origin_;
+            return node;
+        }
+
         template <typename DataT, typename FuncT, typename ParamsT, typename EvalFuncT>
         DataT process_array(FuncT&& func, ParamsT& params, EvalFuncT&& eval_func) const {
             auto count = std::invoke(eval_func, count_, params);
@@ -142,22 +321,38 @@ namespace paracl {
             if constexpr (std::is_same_v<DataT, array_analyze_data_t>) {
                 if (count.type == node_type_e::INPUT) {
                     analyze_t init_value = std::invoke(eval_func, value_, params);
+                    expect_types_ne(init_value.type, node_type_e::MAP, value_->loc(), params);
+                    prove_dense(init_value);
                     return {{init_value}, true};
                 }
                 expect_types_ne(count.type, node_type_e::UNDEF, count_->loc(), params);
                 expect_types_ne(count.type, node_type_e::ARRAY, count_->loc(), params);
+                expect_types_ne(count.type, node_type_e::MAP,   count_->loc(), params);
             }
 
-            int real_count = static_cast<node_number_t*>(count.value)->get_value();
+            int real_count = 0;
+            if constexpr (std::is_same_v<DataT, array_analyze_data_t>) {
+                real_count = static_cast<node_number_t*>(count.value)->get_value();
+            } else {
+                if (!params.is_executed())
+                    return {};
+                expect_types_eq(count.type, node_type_e::INTEGER, count_->loc(), params);
+                real_count = count.number;
+            }
             check_size_out(real_count, params.program_str);
 
-            std::vector<typename DataT::first_type::value_type> values;
-            values.reserve(real_count);
-            std::invoke(func,
-                values, real_count, params, std::invoke(eval_func, value_, params)
-            );
+            typename DataT::values_t values = make_values(params);
+            auto init_value = std::invoke(eval_func, value_, params);
+            if constexpr (std::is_same_v<DataT, array_analyze_data_t>)
+                expect_types_ne(init_value.type, node_type_e::MAP, value_->loc(), params);
+            if (init_value.type != node_type_e::ARRAY && init_value.type != node_type_e::FUNCTION) {
+                values.push_back(init_value);
+                return {std::move(values), count.type == node_type_e::INPUT, real_count};
+            }
 
-            return {values, count.type == node_type_e::INPUT};
+            DataT data{std::move(values), count.type == node_type_e::INPUT};
+            std::invoke(func, data, real_count, params, init_value);
+            return data;
         }
 
         void check_size_out(int size, std::string_view program_str) const {
@@ -174,8 +369,9 @@ namespace paracl {
             assert(count_);
         }
 
-        void add_value_execute(std::vector<execute_t>& values, execute_params_t& params) const override {
-            std::vector<execute_t> result = execute(params).first;
+        // copies of array are elements of list, so they are not kept in storage
+        void add_value_execute(execute_values_t& values, execute_params_t& params) const override {
+            execute_values_t result = execute(params, false).expand();
             if (!params.is_executed())
                 return;
 
@@ -183,14 +379,27 @@ namespace paracl {
         }
 
         void add_value_analyze(std::vector<analyze_t>& values, analyze_params_t& params) override {
-            std::vector<analyze_t> result = analyze(params).first;
+            std::vector<analyze_t> result = analyze(params).expand();
             values.insert(values.end(), result.begin(), result.end());
         }
 
         array_execute_data_t execute(execute_params_t& params) const override {
+            return execute(params, true);
+        }
+
+        array_execute_data_t execute(execute_params_t& params, bool is_storage) const {
             return process_array<array_execute_data_t>(
-                [&](auto& values, int real_count, execute_params_t& params, execute_t init_value) {
-                    std::generate_n(std::back_inserter(values), real_count, [&]() {
+                [&](auto& data, int real_count, execute_params_t& params, execute_t init_value) {
+                    if (init_value.type == node_type_e::ARRAY) {
+                        repeat_array(data, real_count, init_value.value, is_storage && is_dense(), params);
+                        return;
+                    }
+
+                    data.values.reserve(real_count);
+                    std::generate_n(std::back_inserter(data.values), real_count, [&]() {
+                        if (!init_value.is_boxed())
+                            return init_value;
+
                         auto* copy_val = static_cast<node_type_t*>(
                             init_value.value->copy(params.copy_params, nullptr)
                         );
@@ -198,15 +407,16 @@ namespace paracl {
                     });
                 },
                 params,
-                [](auto expr, auto& params) { return expr->execute(params); }
+                [](auto expr, auto& params) { return params.evaluate(expr); }
             );
         }
         
         array_analyze_data_t analyze(analyze_params_t& params) override {
             return process_array<array_analyze_data_t>(
-                [&](auto& values, int real_count, analyze_params_t&, analyze_t init_value) {
+                [&](auto& data, int real_count, analyze_params_t&, analyze_t init_value) {
                     level_ = init_value.value->level();
-                    values.assign(real_count, init_value);
+                    prove_dense(init_value);
+                    data.values.assign(real_count, init_value);
                 },
                 params,
                 [](auto expr, auto& params) { return expr->analyze(params); }
@@ -214,18 +424,40 @@ namespace paracl {
         }
 
         node_array_values_t* copy_vals(copy_params_t& params, scope_base_t* parent) const override {
-            auto& buf = params.buf;
-            return buf->add_node<node_repeat_values_t>(node_loc_t::loc(), value_->copy(params, parent),
-                                                       count_->copy(params, parent));
+            return copy_impl<node_repeat_values_t>(params, parent);
         }
 
         node_array_value_t* copy_val(copy_params_t& params, scope_base_t* parent) const override {
-            auto& buf = params.buf;
-            return buf->add_node<node_repeat_values_t>(node_loc_t::loc(), value_->copy(params, parent),
-                                                       count_->copy(params, parent));
+            return copy_impl<node_repeat_values_t>(params, parent);
         }
 
+        void compile_vals(compile_params_t& params) const override {
+            count_->compile(params);
+            value_->compile(params);
+            params.emit(opcode_e::NEW_REPEAT, count_);
+        }
+
+        void compile_val(compile_params_t& params) const override {
+            count_->compile(params);
+            value_->compile(params);
+            params.emit(opcode_e::ARRAY_APPEND_REPEAT, count_);
+        }
+
+        bool can_pause() const override { return value_->is_pausable() || count_->is_pausable(); }
+        bool can_pause_val() const override { return can_pause(); }
+
         int get_level() const override { return level_; }
+
+        // copies of value have its sizes on nested levels
+        std::vector<range_bound_t> range_sizes(analyze_params_t& params) const override {
+            std::optional<range_bound_t> count = count_->range(params).bound;
+            if (!count || (!count->variable && count->number <= 0))
+                return {};
+
+            std::vector<range_bound_t> sizes{*count};
+            std::ranges::copy(value_->range(params).sizes, std::back_inserter(sizes));
+            return sizes;
+        }
     };
 
     /* ----------------------------------------------------- */
@@ -236,14 +468,18 @@ namespace paracl {
         std::vector<node_array_value_t*> values_;
         int level_ = 0;
 
+        // list of integer literals, e.g. table of constants, is created from them at once
+        std::vector<int> constants_;
+        bool is_constant_ = true;
+
     private:
         template <typename DataT, typename FuncT, typename ParamsT>
         DataT process_values(FuncT&& func, ParamsT& params) const {
-            std::vector<typename DataT::first_type::value_type> values;
+            typename DataT::values_t values = make_values(params);
             std::ranges::for_each(values_, [&](auto value) {
                 std::invoke(func, value, values, params);
             });
-            return {values, false};
+            return {std::move(values), false};
         }
 
         void level_analyze(const std::vector<analyze_t>& a_values, analyze_params_t& params) {
@@ -268,20 +504,33 @@ namespace paracl {
         node_list_values_t(const location_t& loc) : node_loc_t(loc) {}
 
         array_execute_data_t execute(execute_params_t& params) const override {
+            if (is_constant_)
+                return {make_values(params), false, 0, nullptr, constants_};
+
             return process_values<array_execute_data_t>(
                 [](auto value, auto& values, auto& params) { value->add_value_execute(values, params); },
                 params
             );
         }
 
-        void add_value(node_array_value_t* value) { assert(value); values_.push_back(value); }
+        void add_value(node_array_value_t* value) {
+            assert(value);
+            values_.push_back(value);
+
+            std::optional<int> constant = value->constant();
+            is_constant_ &= constant.has_value();
+            if (is_constant_)
+                constants_.push_back(*constant);
+            else
+                constants_.clear();
+        }
 
         array_analyze_data_t analyze(analyze_params_t& params) override {
             auto data = process_values<array_analyze_data_t>(
                 [](auto value, auto& values, auto& params) { value->add_value_analyze(values, params); },
                 params
             );
-            level_analyze(data.first, params);
+            level_analyze(data.values, params);
             return data;
         }
 
@@ -293,211 +542,379 @@ namespace paracl {
             return node_values;
         }
 
+        void compile_vals(compile_params_t& params) const override {
+            if (is_constant_) {
+                params.emit(opcode_e::NEW_CONSTANTS, this, params.add_constants(constants_), constants_.size());
+                return;
+            }
+
+            params.emit(opcode_e::NEW_ARRAY, this);
+            std::ranges::for_each(values_, [&params](auto value) { value->compile_val(params); });
+        }
+
+        bool can_pause() const override {
+            return std::ranges::any_of(values_, [](auto value) { return value->can_pause_val(); });
+        }
+
         int get_level() const override { return level_; }
+
+        std::vector<range_bound_t> range_sizes(analyze_params_t& params) const override {
+            if (values_.size() == 1)
+                return values_.front()->range_sizes(params);
+
+            // sizes of nested arrays may differ
+            long long size = 0;
+            for (auto value : values_) {
+                std::vector<range_bound_t> sizes = value->range_sizes(params);
+                if (sizes.empty() || sizes.front().variable)
+                    return {};
+                size += sizes.front().number;
+            }
+            if (size > std::numeric_limits<int>::max())
+                return {};
+            return {{nullptr, static_cast<int>(size)}};
+        }
     };
 
     /* ----------------------------------------------------- */
 
+    // arrays evaluated at execution live in heap of run, arrays of program hold values as roots of it
     class node_array_t final : public node_type_t,
-                               public node_memory_t {
+                               public node_memory_t,
+                               public heap_node_t {
+        // where elements of evaluated array are kept
+        enum class storage_e {
+            VALUES, // any elements
+            LAZY,   // untouched elements of repeat share its value
+            INTS,   // integers only
+            DENSE,  // view of dimension of rectangular storage of integers
+            SLICE   // elements of other array
+        };
+
         bool is_inited_ = false;
         node_array_values_t* init_values_;
         node_indexes_t*      init_indexes_;
 
-        std::vector<execute_t> e_values_;
+        storage_e storage_ = storage_e::VALUES;
+
+        execute_values_t       e_values_; // views of rows of storage are cached here
         std::vector<analyze_t> a_values_;
 
-        std::vector<execute_t> e_indexes_;
+        lazy_values_t<execute_t> e_lazy_;
+        lazy_values_t<analyze_t> a_lazy_; // values of repeat instead of ones above
+
+        std::pmr::vector<int> e_ints_;
+
+        execute_values_t       e_indexes_;
         std::vector<analyze_t> a_indexes_;
 
         bool is_in_heap_ = false;
         bool is_freed_   = false;
+        bool is_resized_ = false; // size changes after creation, so array isn't rectangular
+
+        dense_t* dense_ = nullptr;
+        int dense_dim_    = 0; // dimension of storage, where array starts
+        int dense_offset_ = 0;
+
+        node_array_t* slice_of_ = nullptr; // array, which elements are shared by this view
+        int slice_begin_ = 0;
+        int slice_size_  = 0;
+
+    protected:
+        void trace(value_heap_t& heap) override {
+            heap.reach(dense_);
+            heap.reach(slice_of_);
+            std::ranges::for_each(e_values_, [&heap](const execute_t& value) { heap.reach(value); });
+            e_lazy_.for_each_distinct([&heap](const execute_t& value) { heap.reach(value); });
+        }
+
+    public:
+        // element, which indexes lead to, cell of storage is found without arrays of its dimensions
+        struct place_t final {
+            node_array_t* array;
+            int  index;
+            int* cell = nullptr;
+        };
 
     private:
-        template <typename DataT, typename FuncT, typename ParamsT>
-        void init(FuncT&& eval_func, ParamsT& params,
-                  std::vector<typename DataT::first_type::value_type>& values,
-                  std::vector<typename DataT::first_type::value_type>& indexes) {
-            auto values_res = std::invoke(eval_func, init_values_, params);
-            values          = values_res.first;
-            is_in_heap_     = values_res.second;
-            indexes         = std::invoke(eval_func, init_indexes_, params);
-            is_inited_      = true;
-        }
-
-        std::string transform_print_str(const std::string& str) const {
-            std::string result = str.substr(0, str.rfind('\n'));
-            size_t pos = result.find('\n');
-            while (pos != std::string::npos) {
-                result.replace(pos, 1, ", ");
-                pos = result.find('\n', pos + 2);
+        // assignment of pmr container keeps memory of destination, so container is rebuilt
+        // on memory of evaluated values
+        template <typename ContainerT>
+        static void replace(ContainerT& container, ContainerT&& values) {
+            std::destroy_at(&container);
+            std::construct_at(&container, std::move(values));
+        }
+
+        void init(execute_params_t& params) {
+            params.heap.add_root(this);
+            array_execute_data_t values_res = init_values_->execute(params);
+            is_in_heap_ = values_res.is_in_heap;
+            set_storage(std::move(values_res), params);
+            replace(e_indexes_, init_indexes_->execute(params));
+
+            if (!params.is_executed())
+                return;
+            is_inited_ = true;
+        }
+
+        void init(analyze_params_t& params) {
+            array_analyze_data_t values_res = init_values_->analyze(params);
+            is_in_heap_ = values_res.is_in_heap;
+            if (values_res.count_repeat > 0) {
+                replace(a_lazy_, make_lazy_values(values_res.count_repeat, values_res.values.front(), params));
+                a_values_.clear();
+            } else {
+                replace(a_lazy_, lazy_values_t<analyze_t>{});
+                a_values_ = std::move(values_res.values);
             }
-            return result;
+            a_indexes_ = init_indexes_->analyze(params);
+            is_inited_ = true;
         }
 
-        static void set_unpredict_below(analyze_t& value, std::vector<analyze_t>& indexes,
-                                        analyze_params_t& params,
-                                        const std::vector<analyze_t>& all_indexes, int depth) {
-            std::vector<analyze_t> tmp_indexes{indexes};
-            analyze_t& result = shift_analyze_step(value, tmp_indexes, params, all_indexes, depth);
-            result.is_constexpr = false;
+        void set_storage(array_execute_data_t&& data, execute_params_t& params) {
+            storage_ = storage_e::VALUES;
+            dense_   = nullptr;
+            e_values_.clear();
+            e_ints_.clear();
+            replace(e_lazy_, lazy_values_t<execute_t>{});
+
+            if (data.dense) {
+                storage_      = storage_e::DENSE;
+                dense_        = data.dense;
+                dense_dim_    = 0;
+                dense_offset_ = 0;
+            } else if (!data.constants.empty()) {
+                storage_ = storage_e::INTS;
+                replace(e_ints_, std::pmr::vector<int>(data.constants.begin(), data.constants.end(),
+                                                       params.resource));
+            } else if (data.count_repeat > 0) {
+                storage_ = storage_e::LAZY;
+                replace(e_lazy_, make_lazy_values(data.count_repeat, data.values.front(), params));
+            } else {
+                replace(e_values_, std::move(data.values));
+            }
         }
 
-        void analyze_check_freed(const location_t& loc, analyze_params_t& params) const {
-            if (is_freed_)
-                throw error_analyze_t{loc, params.program_str,
-                                      "attempt to use freed array"};
+        // arrays of the last dimension keep elements only in storage
+        bool is_dense_row() const noexcept {
+            return storage_ == storage_e::DENSE && dense_dim_ + 1 == dense_->rank();
         }
 
-        template <typename ElemT>
-        location_t get_index_location(size_t depth, const std::vector<ElemT>& all_indexes) const {
-            const auto& index = all_indexes[all_indexes.size() - depth - 1];
+        // view of nested array of storage is made on first access to it
+        execute_t& row(int index, execute_params_t& params) {
+            if (e_values_.empty())
+                replace(e_values_, execute_values_t(size(), params.resource));
 
-            auto indexes = [&]() {
-                if constexpr (std::is_same_v<ElemT, execute_t>) 
-                    return e_indexes_;
-                else 
-                    return a_indexes_;
-            }();
+            execute_t& row = e_values_[index];
+            if (row.is_empty) {
+                auto* view = params.heap.add_node<node_array_t>(node_loc_t::loc(), dense_, dense_dim_ + 1,
+                                                                dense_offset_ + index * dense_->strides[dense_dim_]);
+                row = {node_type_e::ARRAY, view};
+            }
+            return row;
+        }
 
-            if (depth >= indexes.size())
-                return index.value->loc();
+        // elements are copied into vector, so element of any type can be written,
+        // array leaves storage, so storage no longer describes arrays, which contain it
+        void to_values(execute_params_t& params) {
+            execute_values_t values = make_values(params);
+            values.reserve(size());
+            for (int i = 0, end = size(); i < end; ++i)
+                values.push_back(get(i, params));
+
+            if (storage_ == storage_e::DENSE)
+                dense_->is_rectangular = false;
+            replace(e_values_, std::move(values));
+            replace(e_lazy_, lazy_values_t<execute_t>{});
+            e_ints_.clear();
+            dense_   = nullptr;
+            storage_ = storage_e::VALUES;
+        }
+
+        // sizes of rectangular array on levels of nesting are taken from its first elements
+        bool gather_shape(std::pmr::vector<int>& shape, execute_params_t& params) {
+            for (node_array_t* array = this;;) {
+                if (array->size() == 0)
+                    return false;
 
-            return init_indexes_->get_index_loc(indexes.size() - depth - 1);
+                if (array->storage_ == storage_e::DENSE && array->dense_->is_rectangular) {
+                    shape.insert(shape.end(), array->dense_->shape.begin() + array->dense_dim_,
+                                 array->dense_->shape.end());
+                    return true;
+                }
+                shape.push_back(array->size());
+                if (array->has_ints())
+                    return true;
+
+                execute_t value = array->get(0, params);
+                if (value.type != node_type_e::ARRAY)
+                    return true;
+                array = static_cast<node_array_t*>(value.value);
+            }
         }
 
-        template <typename ErrorT, typename ElemT, typename ParamsT>
-        void check_index_out(int index, size_t depth, 
-                             const std::vector<ElemT>& all_indexes,
-                             ParamsT& params) const {
-            if (index < 0) {
-                location_t loc = get_index_location<ElemT>(depth, all_indexes);
-                throw ErrorT{loc, params.program_str,
-                             "wrong index in array: \"" + std::to_string(index) + "\", less than 0"};
+        // integers of array one after another, false if array is not rectangular one of given shape
+        bool gather(std::pmr::vector<int>& elems, std::span<const int> shape, execute_params_t& params) {
+            if (size() != shape.front())
+                return false;
+
+            if (has_ints()) {
+                if (shape.size() != 1)
+                    return false;
+                std::span<int> ints = this->ints();
+                elems.insert(elems.end(), ints.begin(), ints.end());
+                return true;
             }
 
-            int array_size = std::is_same_v<ElemT, execute_t> ? e_values_.size() : a_values_.size();
-            if (index >= array_size && (!is_in_heap_ || !std::is_same_v<ElemT, analyze_t>)) {
-                location_t loc = get_index_location<ElemT>(depth, all_indexes);
-                throw ErrorT{loc, params.program_str,
-                               "wrong index in array: \"" + std::to_string(index)
-                             + "\", when array size: \""  + std::to_string(array_size) + "\""};
+            if (storage_ == storage_e::DENSE && dense_->is_rectangular) {
+                if (!std::ranges::equal(shape, std::span<const int>{dense_->shape}.subspan(dense_dim_)))
+                    return false;
+                auto begin = dense_->elems.begin() + dense_offset_;
+                elems.insert(elems.end(), begin, begin + dense_->count(dense_dim_));
+                return true;
+            }
+
+            for (int i = 0; i < shape.front(); ++i) {
+                execute_t value = get(i, params);
+                if (shape.size() == 1) {
+                    if (value.type != node_type_e::INTEGER)
+                        return false;
+                    elems.push_back(value.number);
+                } else if (value.type != node_type_e::ARRAY ||
+                           !static_cast<node_array_t*>(value.value)->gather(elems, shape.subspan(1), params)) {
+                    return false;
+                }
             }
+            return true;
         }
 
-        execute_t& shift_(std::vector<execute_t>& indexes, execute_params_t& params,
-                          const std::vector<execute_t>& all_indexes, int depth) {
-            execute_t index_value = indexes.back().value->execute(params);
-            if (!params.is_executed())
-                return e_values_[0];
+        // rectangular array of integers is repeated into new storage, nullptr if it is not such one
+        dense_t* repeat_dense(int count, execute_params_t& params) {
+            std::pmr::vector<int> shape{params.resource};
+            std::pmr::vector<int> elems{params.resource};
+            if (!gather_shape(shape, params) || !gather(elems, shape, params))
+                return nullptr;
+
+            dense_t* dense = params.heap.add_node<dense_t>(params.resource);
+            dense->shape.push_back(count);
+            dense->shape.insert(dense->shape.end(), shape.begin(), shape.end());
+            dense->set_strides();
+
+            dense->elems.reserve(static_cast<size_t>(count) * elems.size());
+            for (int i = 0; i < count; ++i)
+                dense->elems.insert(dense->elems.end(), elems.begin(), elems.end());
+            params.heap.add_values(dense->elems.size());
+            return dense;
+        }
 
-            node_number_t* node_index = static_cast<node_number_t*>(index_value.value);
-            int index = node_index->get_value();
-            indexes.pop_back();
+        // storage of rectangular view is copied with its shape
+        node_array_t* clone_dense(execute_params_t& params) const {
+            dense_t* dense = params.heap.add_node<dense_t>(params.resource);
+            dense->shape.assign(dense_->shape.begin() + dense_dim_, dense_->shape.end());
+            dense->strides.assign(dense_->strides.begin() + dense_dim_, dense_->strides.end());
 
-            check_index_out<error_execute_t>(index, depth, all_indexes, params);
+            auto begin = dense_->elems.begin() + dense_offset_;
+            dense->elems.assign(begin, begin + dense_->count(dense_dim_));
+            params.heap.add_values(dense->elems.size());
+            return params.heap.add_node<node_array_t>(node_loc_t::loc(), dense, 0, 0);
+        }
+
+        int a_size() const noexcept { return a_lazy_.empty() ? a_values_.size() : a_lazy_.size(); }
 
-            execute_t& result = e_values_[index];
+        analyze_t& a_at(int index) { return a_lazy_.empty() ? a_values_[index] : a_lazy_.at(index, true); }
 
-            if (!indexes.empty() && result.type == node_type_e::ARRAY)
-                return static_cast<node_array_t*>(result.value)->shift_(indexes, params,
-                                                                        all_indexes, depth + 1);
+        template <typename FuncT>
+        void a_for_each(FuncT&& func) {
+            if (a_lazy_.empty())
+                std::ranges::for_each(a_values_, func);
             else
-                return result;
-        }
-
-        static analyze_t& shift_analyze_step(analyze_t& value, std::vector<analyze_t>& indexes,
-                                             analyze_params_t& params,
-                                             const std::vector<analyze_t>& all_indexes, int depth) {
-            if (value.type == node_type_e::ARRAY) {
-                if (!indexes.empty())
-                    return static_cast<node_array_t*>(value.value)->shift_analyze_(indexes, params,
-                                                                                   all_indexes, depth);
-                else
-                    return value;
-            } else {
-                if (!indexes.empty())
-                    throw error_analyze_t{indexes[0].value->loc(), params.program_str,
-                                          "indexing in depth has gone beyond boundary of array"};
-                return value;
-            }
+                a_lazy_.for_each_distinct(func);
         }
 
-        analyze_t& shift_analyze_size_type_input(std::vector<analyze_t>& indexes, analyze_params_t& params,
-                                                 const std::vector<analyze_t>& all_indexes, int depth) {
-            analyze_t& result = a_values_[0];
-            indexes.pop_back();
-            return shift_analyze_step(result, indexes, params, all_indexes, depth + 1);
+        static void set_unpredict_below(analyze_t& value, std::span<const analyze_t> indexes,
+                                        analyze_params_t& params, int depth) {
+            analyze_t& result = shift_analyze_step(value, indexes, params, depth);
+            result.is_constexpr = false;
         }
 
-        analyze_t& shift_analyze_number(std::vector<analyze_t>& indexes, node_number_t* index_node,
-                                        analyze_params_t& params,
-                                        const std::vector<analyze_t>& all_indexes, int depth) {
-            int index = index_node->get_value();
-            indexes.pop_back();
-            analyze_t& result = a_values_[index];
-            return shift_analyze_step(result, indexes, params, all_indexes, depth + 1);
+        void analyze_check_freed(const location_t& loc, analyze_params_t& params) const {
+            if (is_freed_)
+                throw error_analyze_t{loc, params.program_str,
+                                      "attempt to use freed array"};
         }
 
-        analyze_t& shift_analyze_unpredict(std::vector<analyze_t>& indexes, analyze_params_t& params,
-                                           const std::vector<analyze_t>& all_indexes, int depth) {
-            indexes.pop_back();
-            std::ranges::for_each(a_values_, [&](auto a_value) {
-                set_unpredict_below(a_value, indexes, params, all_indexes, depth + 1);
-            });
-            return shift_analyze_step(a_values_[0], indexes, params, all_indexes, depth);
+        location_t get_index_location(size_t depth, std::span<const analyze_t> indexes) const {
+            if (depth >= a_indexes_.size())
+                return indexes[depth].value->loc();
+
+            return init_indexes_->get_index_loc(depth);
+        }
+
+        template <typename ErrorT, typename LocFuncT, typename ParamsT>
+        static void check_index_out(int index, int array_size, LocFuncT&& get_loc, ParamsT& params) {
+            if (index < 0)
+                throw ErrorT{get_loc(), params.program_str,
+                             "wrong index in array: \"" + std::to_string(index) + "\", less than 0"};
+
+            if (index >= array_size)
+                throw ErrorT{get_loc(), params.program_str,
+                               "wrong index in array: \"" + std::to_string(index)
+                             + "\", when array size: \""  + std::to_string(array_size) + "\""};
+        }
+
+        // indexes of access are walked by depth without copies of them
+        static analyze_t& shift_analyze_step(analyze_t& value, std::span<const analyze_t> indexes,
+                                             analyze_params_t& params, int depth) {
+            if (depth == static_cast<int>(indexes.size()))
+                return value;
+
+            if (value.type != node_type_e::ARRAY)
+                throw error_analyze_t{indexes[depth].value->loc(), params.program_str,
+                                      "indexing in depth has gone beyond boundary of array"};
+            return static_cast<node_array_t*>(value.value)->shift_analyze_(indexes, params, depth);
         }
 
-        analyze_t& shift_analyze_(std::vector<analyze_t>& indexes, analyze_params_t& params,
-                                  const std::vector<analyze_t>& all_indexes, int depth) {
+        analyze_t& shift_analyze_unpredict(std::span<const analyze_t> indexes, analyze_params_t& params,
+                                           int depth) {
+            a_for_each([&](auto a_value) { set_unpredict_below(a_value, indexes, params, depth + 1); });
+            return shift_analyze_step(a_at(0), indexes, params, depth + 1);
+        }
+
+        analyze_t& shift_analyze_(std::span<const analyze_t> indexes, analyze_params_t& params, int depth) {
             if (is_in_heap_)
-                return shift_analyze_size_type_input(indexes, params, all_indexes, depth);
+                return shift_analyze_step(a_at(0), indexes, params, depth + 1);
 
-            analyze_t index = indexes.back();
+            const analyze_t& index = indexes[depth];
             if (index.is_constexpr &&
                 index.type == node_type_e::INTEGER) {
 
-                node_number_t* node_index = static_cast<node_number_t*>(index.value);
-
-                if (index.is_constexpr) {
-                    check_index_out<error_analyze_t>(
-                        node_index->get_value(), depth, all_indexes, params
-                    );
-                }
-                return shift_analyze_number(indexes, node_index, params, all_indexes, depth);
+                int number = static_cast<node_number_t*>(index.value)->get_value();
+                check_index_out<error_analyze_t>(
+                    number, a_size(), [&]() { return get_index_location(depth, indexes); }, params
+                );
+                return shift_analyze_step(a_at(number), indexes, params, depth + 1);
             }
 
-            return shift_analyze_unpredict(indexes, params, all_indexes, depth);
+            return shift_analyze_unpredict(indexes, params, depth);
         }
 
-        template <typename DataT, typename ParamsT>
-        DataT::first_type::value_type process(ParamsT& params) {
-            using ElemT = DataT::first_type::value_type;
+        template <typename ElemT, typename ParamsT>
+        ElemT process(ParamsT& params) {
             constexpr bool is_array_execute = std::is_same_v<ElemT, execute_t>;
-            constexpr bool is_array_analyze = std::is_same_v<ElemT, analyze_t>;
 
-            if constexpr (is_array_analyze)
+            if constexpr (!is_array_execute)
                 analyze_check_freed(node_loc_t::loc(), params);
 
-            auto [values, indexes] = [&]() {
-                if constexpr (is_array_execute)
-                    return std::make_tuple(std::ref(e_values_), std::ref(e_indexes_));
-                else
-                    return std::make_tuple(std::ref(a_values_), std::ref(a_indexes_));
-            }();
-
-            auto func = [](auto* node, auto& params) {
-                if constexpr (is_array_execute)
-                    return node->execute(params);
-                else
-                    return node->analyze(params);
-            };
-
             if (!is_inited_)
-                init<DataT>(func, params, values, indexes);
+                init(params);
 
-            if (!indexes.empty())
-                return shift(std::vector<ElemT>{}, params);
+            if constexpr (is_array_execute) {
+                if (!e_indexes_.empty())
+                    return load(std::span<const execute_t>{}, nullptr, params);
+            } else {
+                if (!a_indexes_.empty())
+                    return shift(std::span<const analyze_t>{}, params);
+            }
             return {node_type_e::ARRAY, this};
         }
 
@@ -508,70 +925,378 @@ namespace paracl {
             assert(init_indexes_);
         }
 
+        // evaluated array of any elements
+        node_array_t(const location_t& loc, execute_values_t&& values)
+        : node_type_t(loc), is_inited_(true), init_values_(nullptr), init_indexes_(nullptr),
+          e_values_(std::move(values)) {}
+
+        // evaluated array of integers
+        node_array_t(const location_t& loc, std::pmr::vector<int>&& ints)
+        : node_type_t(loc), is_inited_(true), init_values_(nullptr), init_indexes_(nullptr),
+          storage_(storage_e::INTS), e_ints_(std::move(ints)) {}
+
+        // evaluated view of dimension dim of storage
+        node_array_t(const location_t& loc, dense_t* dense, int dim, int offset)
+        : node_type_t(loc), is_inited_(true), init_values_(nullptr), init_indexes_(nullptr),
+          storage_(storage_e::DENSE), dense_(dense), dense_dim_(dim), dense_offset_(offset) { assert(dense_); }
+
+        // evaluated view over size elements of array from begin
+        node_array_t(const location_t& loc, node_array_t* slice_of, int begin, int size)
+        : node_type_t(loc), is_inited_(true), init_values_(nullptr), init_indexes_(nullptr),
+          storage_(storage_e::SLICE), slice_of_(slice_of), slice_begin_(begin), slice_size_(size) {}
+
+        // view keeps in bounds of its array, even if that one was freed
+        int size() const noexcept {
+            switch (storage_) {
+                case storage_e::SLICE: return std::clamp(slice_of_->size() - slice_begin_, 0, slice_size_);
+                case storage_e::LAZY:  return e_lazy_.size();
+                case storage_e::INTS:  return e_ints_.size();
+                case storage_e::DENSE: return dense_->shape[dense_dim_];
+                default:               return e_values_.size();
+            }
+        }
+
+        execute_t get(int index, execute_params_t& params) {
+            switch (storage_) {
+                case storage_e::SLICE: return slice_of_->get(slice_begin_ + index, params);
+                case storage_e::LAZY:  return e_lazy_.at(index, false);
+                case storage_e::INTS:  return execute_t{e_ints_[index]};
+                case storage_e::DENSE:
+                    if (is_dense_row())
+                        return execute_t{dense_->elems[dense_offset_ + index]};
+                    return row(index, params);
+                default: return e_values_[index];
+            }
+        }
+
+        // untouched elements of repeat share one value, so element to write is materialized,
+        // replaced nested array of storage makes it not rectangular
+        void set(int index, const execute_t& value, execute_params_t& params) {
+            switch (storage_) {
+                case storage_e::SLICE: slice_of_->set(slice_begin_ + index, value, params); return;
+                case storage_e::LAZY:  e_lazy_.at(index, true) = value; return;
+                case storage_e::INTS:
+                    if (value.type == node_type_e::INTEGER) {
+                        e_ints_[index] = value.number;
+                        return;
+                    }
+                    break;
+                case storage_e::DENSE:
+                    if (!is_dense_row()) {
+                        row(index, params) = value;
+                        dense_->is_rectangular = false;
+                        return;
+                    }
+                    if (value.type == node_type_e::INTEGER) {
+                        dense_->elems[dense_offset_ + index] = value.number;
+                        return;
+                    }
+                    break;
+                default: break;
+            }
+
+            if (storage_ != storage_e::VALUES)
+                to_values(params);
+            e_values_[index] = value;
+        }
+
+        // integers of array, which keeps them one after another
+        bool has_ints() const noexcept { return storage_ == storage_e::INTS || is_dense_row(); }
+
+        std::span<int> ints() noexcept {
+            assert(has_ints());
+            if (storage_ == storage_e::INTS)
+                return e_ints_;
+            return {dense_->elems.data() + dense_offset_, static_cast<size_t>(size())};
+        }
+
+        heap_node_t* heap_node() noexcept override { return this; }
+
+        size_t count_values() const noexcept override { return e_values_.size() + e_ints_.size(); }
+
         execute_t execute(execute_params_t& params) override {
-            return process<array_execute_data_t>(params);
+            return process<execute_t>(params);
         }
 
         analyze_t analyze(analyze_params_t& params) override {
-            return process<array_analyze_data_t>(params);
+            return process<analyze_t>(params);
         }
 
-        template <typename ElemT, typename ParamsT>
-        ElemT& shift(const std::vector<ElemT>& ext_indexes, ParamsT& params) {
-            constexpr bool is_array_execute = std::is_same_v<ElemT, execute_t>;
-            constexpr bool is_array_analyze = std::is_same_v<ElemT, analyze_t>;
+        // own indexes of array initialization are applied before external ones,
+        // indexes after the first non array element are ignored. all dimensions of rectangular
+        // storage are passed at once, if is_strided
+        place_t find(std::span<const execute_t> ext_indexes, const node_indexes_t* ext_source,
+                     bool is_strided, execute_params_t& params) {
+            const int count_own = e_indexes_.size();
+            const int count_all = count_own + ext_indexes.size();
+            assert(count_all > 0);
+
+            auto check_index = [&](int depth, int array_size) {
+                bool is_own = depth < count_own;
+                const execute_t& index = is_own ? e_indexes_[depth] : ext_indexes[depth - count_own];
+                auto get_loc = [&]() {
+                    return is_own ? init_indexes_->get_index_loc(depth)
+                                  : ext_source->get_index_loc(depth - count_own);
+                };
+
+                if (index.type != node_type_e::INTEGER)
+                    throw error_execute_t{get_loc(), params.program_str, "wrong type: " + type2str(index.type)};
+                if (is_own || !ext_source->is_in_bounds(depth - count_own))
+                    check_index_out<error_execute_t>(index.number, array_size, get_loc, params);
+                return index.number;
+            };
+
+            node_array_t* array = this;
+            for (int depth = 0;;) {
+                dense_t* dense = array->dense_;
+                if (is_strided && array->storage_ == storage_e::DENSE &&
+                    (dense->is_rectangular || array->is_dense_row()) &&
+                    count_all - depth >= dense->rank() - array->dense_dim_) {
+                    int offset = array->dense_offset_;
+                    for (int dim = array->dense_dim_, rank = dense->rank(); dim < rank; ++dim, ++depth)
+                        offset += check_index(depth, dense->shape[dim]) * dense->strides[dim];
+                    return {array, 0, &dense->elems[offset]};
+                }
 
-            const auto& indexes = [&]() -> const auto& {
-                if constexpr (is_array_execute)
-                    return e_indexes_;
-                else
-                    return a_indexes_;
-            }();
+                int index = check_index(depth, array->size());
+                if (++depth == count_all)
+                    return {array, index};
 
-            std::vector<ElemT> all_indexes = ext_indexes;
-            all_indexes.insert(all_indexes.end(), indexes.begin(), indexes.end());
+                execute_t value = array->get(index, params);
+                if (value.type != node_type_e::ARRAY)
+                    return {array, index};
+                array = static_cast<node_array_t*>(value.value);
+            }
+        }
 
-            if constexpr (is_array_analyze)
-                analyze_check_freed(all_indexes[0].value->loc(), params);
+        execute_t load(std::span<const execute_t> ext_indexes, const node_indexes_t* ext_source,
+                       execute_params_t& params) {
+            place_t place = find(ext_indexes, ext_source, true, params);
+            return place.cell ? execute_t{*place.cell} : place.array->get(place.index, params);
+        }
 
-            if constexpr (is_array_execute)
-                return shift_(all_indexes, params, std::vector<execute_t>{all_indexes}, 0);
+        // integer is written into cell of storage, any other value needs array of its dimension
+        void store(std::span<const execute_t> ext_indexes, const node_indexes_t* ext_source,
+                   const execute_t& value, execute_params_t& params) {
+            place_t place = find(ext_indexes, ext_source, value.type == node_type_e::INTEGER, params);
+            if (place.cell)
+                *place.cell = value.number;
             else
-                return shift_analyze_(all_indexes, params, std::vector<analyze_t>{all_indexes}, 0);
+                place.array->set(place.index, value, params);
+        }
+
+        // own indexes of array initialization are applied before external ones
+        analyze_t& shift(std::span<const analyze_t> ext_indexes, analyze_params_t& params) {
+            std::span<const analyze_t> indexes = ext_indexes;
+            std::vector<analyze_t> all_indexes;
+            if (!a_indexes_.empty()) {
+                all_indexes.reserve(a_indexes_.size() + ext_indexes.size());
+                std::ranges::copy(a_indexes_, std::back_inserter(all_indexes));
+                std::ranges::copy(ext_indexes, std::back_inserter(all_indexes));
+                indexes = all_indexes;
+            }
+
+            analyze_check_freed(indexes.back().value->loc(), params);
+            return shift_analyze_(indexes, params, 0);
         }
 
         void print(execute_params_t& params) override {
             if (!e_indexes_.empty()) {
-                execute_t& value = shift(std::vector<execute_t>{}, params);
+                execute_t value = load(std::span<const execute_t>{}, nullptr, params);
                 if (!params.is_executed()) return;
-                value.value->print(params);
+                print_value(value, params);
                 return;
             }
             execute(params);
             if (!params.is_executed()) return;
 
-            std::stringstream print_stream;
-            execute_params_t print_params = params;
-            print_params.os = &print_stream;
-
-            std::ranges::for_each(e_values_, [&print_params](auto e_value) {
-                e_value.value->print(print_params);
-            });
-
-            *(params.os) << '[' << transform_print_str(print_stream.str()) << "]\n";
+            // elements are written to output one after another
+            std::ostream& os = *(params.os);
+            os << '[';
+            for (int i = 0, end = size(); i < end; ++i) {
+                if (i > 0)
+                    os << ", ";
+                print_value(get(i, params), params);
+            }
+            os << ']';
         }
 
         void clear() {
             is_inited_ = false;
             if (is_in_heap_) {
                 is_freed_ = true;
+                storage_  = storage_e::VALUES;
                 e_values_.clear();
                 a_values_.clear();
+                replace(e_lazy_, lazy_values_t<execute_t>{});
+                replace(a_lazy_, lazy_values_t<analyze_t>{});
+                e_ints_.clear();
+                dense_ = nullptr;
                 e_indexes_.clear();
                 a_indexes_.clear();
             }
         }
 
+        // copies of nodes would be evaluated only on access, so evaluated elements are cloned
+        void repeat(array_execute_data_t& data, int count, bool is_dense, execute_params_t& params) {
+            if (is_dense)
+                if ((data.dense = repeat_dense(count, params)))
+                    return;
+
+            data.values.reserve(count);
+            for (int i = 0; i < count; ++i)
+                data.values.push_back({node_type_e::ARRAY, clone(params)});
+        }
+
+        node_array_t* clone(execute_params_t& params) {
+            if (has_ints()) {
+                std::span<int> ints = this->ints();
+                params.heap.add_values(ints.size());
+                return params.heap.add_node<node_array_t>(
+                    node_loc_t::loc(), std::pmr::vector<int>(ints.begin(), ints.end(), params.resource)
+                );
+            }
+            if (storage_ == storage_e::DENSE && dense_->is_rectangular)
+                return clone_dense(params);
+
+            execute_values_t values = make_values(params);
+            values.reserve(size());
+            for (int i = 0, end = size(); i < end; ++i) {
+                execute_t value = get(i, params);
+                if (value.type == node_type_e::ARRAY)
+                    value.value = static_cast<node_array_t*>(value.value)->clone(params);
+                else if (value.is_boxed())
+                    value.value = static_cast<node_type_t*>(value.value->copy(params.copy_params, nullptr));
+                values.push_back(value);
+            }
+            params.heap.add_values(values.size());
+            return params.heap.add_node<node_array_t>(node_loc_t::loc(), std::move(values));
+        }
+
+        // slice of view is view over the same array
+        node_array_t* slice(int begin, int end, const location_t& loc, execute_params_t& params) {
+            if (begin < 0 || begin >= end || end > size())
+                throw error_execute_t{loc, params.program_str,
+                                        "wrong bounds of slice: \"" + std::to_string(begin) + ':'
+                                      + std::to_string(end) + "\", when array size: \""
+                                      + std::to_string(size()) + "\""};
+
+            if (slice_of_)
+                return slice_of_->slice(slice_begin_ + begin, slice_begin_ + end, loc, params);
+            return params.heap.add_node<node_array_t>(node_loc_t::loc(), this, begin, end - begin);
+        }
+
+        // element by index, which is unknown before execution
+        analyze_t analyze_element(const location_t& loc, analyze_params_t& params) {
+            analyze_check_freed(loc, params);
+            analyze_t element = a_at(0);
+            element.is_constexpr = false;
+            return element;
+        }
+
+        // elements of array may be written through its slice, so they are no longer known
+        analyze_t analyze_slice(const location_t& loc, analyze_params_t& params) {
+            analyze_check_freed(loc, params);
+            a_for_each([](analyze_t& value) { value.is_constexpr = false; });
+            return a_at(0);
+        }
+
+        // size of resized array is known only at execution as size of heap one. index of resized array
+        // may be unknown, so all arrays on its depth of nesting are resized
+        void analyze_resize(int depth, const location_t& loc, analyze_params_t& params) {
+            analyze_check_freed(loc, params);
+            a_for_each([&](analyze_t& value) {
+                if (depth == 0)
+                    value.is_constexpr = false;
+                else if (value.type == node_type_e::ARRAY)
+                    static_cast<node_array_t*>(value.value)->analyze_resize(depth - 1, loc, params);
+            });
+            if (depth == 0)
+                is_in_heap_ = is_resized_ = true;
+        }
+
+        // sizes of rectangular array of integers on levels of nesting, -1 for size known only
+        // at execution. nested arrays of such size have to be one array
+        std::optional<std::vector<int>> analyze_shape() {
+            if (is_resized_ || a_size() == 0)
+                return std::nullopt;
+
+            std::optional<std::vector<int>> row_shape;
+            node_type_t* first_row = nullptr;
+            bool is_leaf  = false;
+            bool is_dense = true;
+            a_for_each([&](const analyze_t& value) {
+                if (!is_dense)
+                    return;
+
+                if (value.type != node_type_e::ARRAY) {
+                    is_leaf  = true;
+                    is_dense = !first_row && value.type != node_type_e::UNDEF &&
+                               to_general_type(value.type) == general_type_e::INTEGER;
+                    return;
+                }
+                if (is_leaf) {
+                    is_dense = false;
+                } else if (!first_row) {
+                    first_row = value.value;
+                    row_shape = static_cast<node_array_t*>(first_row)->analyze_shape();
+                    is_dense  = row_shape.has_value();
+                } else if (value.value != first_row) {
+                    std::optional<std::vector<int>> shape = static_cast<node_array_t*>(value.value)->analyze_shape();
+                    is_dense = shape == row_shape && std::ranges::find(*row_shape, -1) == row_shape->end();
+                }
+            });
+            if (!is_dense)
+                return std::nullopt;
+
+            std::vector<int> shape{is_in_heap_ ? -1 : a_size()};
+            if (row_shape)
+                shape.insert(shape.end(), row_shape->begin(), row_shape->end());
+            return shape;
+        }
+
+        // resized array keeps its elements in vector, which grows geometrically,
+        // so elements of repeat or storage are copied to it
+        void make_growable(const location_t& loc, execute_params_t& params) {
+            if (storage_ == storage_e::SLICE)
+                throw error_execute_t{loc, params.program_str, "attempt to resize slice of array"};
+
+            if (is_dense_row()) {
+                std::span<int> ints = this->ints();
+                replace(e_ints_, std::pmr::vector<int>(ints.begin(), ints.end(), params.resource));
+                dense_->is_rectangular = false;
+                dense_   = nullptr;
+                storage_ = storage_e::INTS;
+            } else if (storage_ == storage_e::LAZY || storage_ == storage_e::DENSE) {
+                to_values(params);
+            }
+        }
+
+        int push(const execute_t& value, const location_t& loc, execute_params_t& params) {
+            make_growable(loc, params);
+            if (storage_ == storage_e::INTS && value.type != node_type_e::INTEGER)
+                to_values(params);
+
+            if (storage_ == storage_e::INTS)
+                e_ints_.push_back(value.number);
+            else
+                e_values_.push_back(value);
+            return size();
+        }
+
+        execute_t pop(const location_t& loc, execute_params_t& params) {
+            make_growable(loc, params);
+            if (size() == 0)
+                throw error_execute_t{loc, params.program_str, "attempt to pop from empty array"};
+
+            execute_t value = get(size() - 1, params);
+            if (storage_ == storage_e::INTS)
+                e_ints_.pop_back();
+            else
+                e_values_.pop_back();
+            return value;
+        }
+
         node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
             auto& buf = params.buf;
             node_array_t* node_array = buf->add_node<node_array_t>(node_loc_t::loc(),
@@ -582,6 +1307,165 @@ namespace paracl {
             return node_array;
         }
 
+        void compile(compile_params_t& params) const override {
+            init_values_->compile_vals(params);
+            init_indexes_->compile(params);
+            if (!init_indexes_->empty())
+                params.emit(opcode_e::INDEX, init_indexes_, 0, init_indexes_->size());
+        }
+
         int level() const override { return 1 + init_values_->get_level(); }
+
+        bool can_pause() const override { return init_values_->can_pause() || init_indexes_->can_pause(); }
+
+        range_value_t range(analyze_params_t& params) const override {
+            range_value_t result;
+            if (init_values_ && init_indexes_->empty())
+                result.sizes = init_values_->range_sizes(params);
+            return result;
+        }
+    };
+
+    /* ----------------------------------------------------- */
+
+    inline void repeat_array(array_execute_data_t& data, int count, node_type_t* array, bool is_dense,
+                             execute_params_t& params) {
+        static_cast<node_array_t*>(array)->repeat(data, count, is_dense, params);
+    }
+
+    inline bool analyze_dense(const analyze_t& array) {
+        return static_cast<node_array_t*>(array.value)->analyze_shape().has_value();
+    }
+
+    /* ----------------------------------------------------- */
+
+    // elements of array are known only at execution, so it is analyzed as array of input size,
+    // which elements are like given one
+    class node_unknown_values_t final : public node_t,
+                                        public node_array_values_t {
+        analyze_t elem_;
+
+    public:
+        node_unknown_values_t(const analyze_t& elem) : elem_(elem) {}
+
+        array_execute_data_t execute(execute_params_t& params) const override {
+            throw error_t{str_red("node_unknown_values_t: execute() failed: values exist only in analysis")};
+        }
+
+        array_analyze_data_t analyze(analyze_params_t& params) override { return {{elem_}, true}; }
+
+        int get_level() const override { return elem_.type == node_type_e::ARRAY ? elem_.value->level() : 0; }
+
+        node_array_values_t* copy_vals(copy_params_t& params, scope_base_t* parent) const override {
+            throw error_t{str_red("node_unknown_values_t: copy_vals() failed: values exist only in analysis")};
+        }
+
+        void compile_vals(compile_params_t& params) const override {
+            throw error_t{str_red("node_unknown_values_t: compile_vals() failed: values exist only in analysis")};
+        }
+
+        bool can_pause() const override { return false; }
     };
+
+    inline analyze_t analyze_unknown_array(const location_t& loc, const analyze_t& elem, node_indexes_t* indexes,
+                                           analyze_params_t& params) {
+        auto* values = params.buf()->add_node<node_unknown_values_t>(elem);
+        if (!indexes)
+            indexes = params.buf()->add_node<node_indexes_t>(loc);
+        return params.buf()->add_node<node_array_t>(loc, values, indexes)->analyze(params);
+    }
+
+    /* ----------------------------------------------------- */
+
+    // operand of kernel is array with integers one after another or integer for every element
+    inline std::optional<simd_operand_t> to_simd_operand(node_array_t* array, const execute_t& value) {
+        if (!array)
+            return value.type == node_type_e::INTEGER ? std::optional{simd_operand_t{nullptr, value.number}}
+                                                      : std::nullopt;
+        if (!array->has_ints())
+            return std::nullopt;
+        return simd_operand_t{array->ints().data()};
+    }
+
+    // result of integer operands keeps integers one after another, kernel of operator runs over them
+    // and without kernel operator is applied to every pair of integers
+    template <typename FuncT>
+    execute_t elementwise_ints(simd_operand_t lhs, simd_operand_t rhs, int size, std::optional<simd_op_e> op,
+                               FuncT&& func, const location_t& loc, execute_params_t& params) {
+        std::pmr::vector<int> ints(size, params.resource);
+        if (op)
+            simd_apply(*op, lhs, rhs, ints);
+        else
+            for (int i = 0; i < size; ++i)
+                ints[i] = func(lhs[i], rhs[i]);
+
+        params.heap.add_values(ints.size());
+        return {node_type_e::ARRAY, params.heap.add_node<node_array_t>(loc, std::move(ints))};
+    }
+
+    // arrays are combined element by element and integer is combined with every element of array,
+    // undef element gives undef one as for operands themselves
+    template <typename FuncT>
+    execute_t elementwise(const execute_t& lhs, const execute_t& rhs, std::optional<simd_op_e> op, FuncT&& func,
+                          const location_t& loc, execute_params_t& params) {
+        if (lhs.type == node_type_e::UNDEF || rhs.type == node_type_e::UNDEF)
+            return execute_t{node_type_e::UNDEF};
+
+        if (lhs.type != node_type_e::ARRAY && rhs.type != node_type_e::ARRAY) {
+            expect_types_eq(lhs.type, node_type_e::INTEGER, loc, params);
+            expect_types_eq(rhs.type, node_type_e::INTEGER, loc, params);
+            return execute_t{func(lhs.number, rhs.number)};
+        }
+
+        auto* l_array = lhs.type == node_type_e::ARRAY ? static_cast<node_array_t*>(lhs.value) : nullptr;
+        auto* r_array = rhs.type == node_type_e::ARRAY ? static_cast<node_array_t*>(rhs.value) : nullptr;
+        const int size = l_array ? l_array->size() : r_array->size();
+        if (l_array && r_array && r_array->size() != size)
+            throw error_execute_t{loc, params.program_str,
+                                    "different sizes of arrays in operator: \"" + std::to_string(size)
+                                  + "\" and \"" + std::to_string(r_array->size()) + "\""};
+
+        std::optional<simd_operand_t> l_ints = to_simd_operand(l_array, lhs);
+        std::optional<simd_operand_t> r_ints = to_simd_operand(r_array, rhs);
+        if (l_ints && r_ints)
+            return elementwise_ints(*l_ints, *r_ints, size, op, func, loc, params);
+
+        execute_values_t values = make_values(params);
+        values.resize(size);
+        for (int i = 0; i < size; ++i) {
+            const execute_t l_elem = l_array ? l_array->get(i, params) : lhs;
+            const execute_t r_elem = r_array ? r_array->get(i, params) : rhs;
+            if (l_elem.type == node_type_e::INTEGER && r_elem.type == node_type_e::INTEGER) [[likely]]
+                values[i] = execute_t{func(l_elem.number, r_elem.number)};
+            else
+                values[i] = elementwise(l_elem, r_elem, op, func, loc, params);
+        }
+        params.heap.add_values(values.size());
+        return {node_type_e::ARRAY, params.heap.add_node<node_array_t>(loc, std::move(values))};
+    }
+
+    // kernel of unary operator takes 0 as left operand: 0 - x, 0 == x and 0 + x
+    template <typename FuncT>
+    execute_t elementwise(const execute_t& value, std::optional<simd_op_e> op, FuncT&& func,
+                          const location_t& loc, execute_params_t& params) {
+        if (value.type == node_type_e::UNDEF)
+            return value;
+
+        if (value.type != node_type_e::ARRAY) {
+            expect_types_eq(value.type, node_type_e::INTEGER, loc, params);
+            return execute_t{func(value.number)};
+        }
+
+        auto* array = static_cast<node_array_t*>(value.value);
+        if (array->has_ints())
+            return elementwise_ints(simd_operand_t{nullptr, 0}, simd_operand_t{array->ints().data()}, array->size(),
+                                    op, [&func](int, int r_value) { return func(r_value); }, loc, params);
+
+        execute_values_t values = make_values(params);
+        values.resize(array->size());
+        for (int i = 0, end = array->size(); i < end; ++i)
+            values[i] = elementwise(array->get(i, params), op, func, loc, params);
+        params.heap.add_values(values.size());
+        return {node_type_e::ARRAY, params.heap.add_node<node_array_t>(loc, std::move(values))};
+    }
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "ParaCL/nodes/lvalue.hpp"
+#include "ParaCL/nodes/simple_types.hpp"
+
+namespace paracl {
+    enum class array_builtins_e {
+        PUSH,
+        POP,
+        LEN
+    };
+
+    inline opcode_e to_opcode(array_builtins_e type) {
+        switch (type) {
+            case array_builtins_e::PUSH: return opcode_e::ARRAY_PUSH;
+            case array_builtins_e::POP:  return opcode_e::ARRAY_POP;
+            case array_builtins_e::LEN:  return opcode_e::ARRAY_LEN;
+            default: throw error_t{str_red("failed to_opcode(): unknown array builtin")};
+        }
+    }
+
+    // push(array, value) appends value and gives new size, pop(array) removes the last element and gives it,
+    // len(array) gives size. array is resized in place, so all its variables see new size
+    class node_array_builtin_t;
+    template <> inline constexpr bool is_arena_only_v<node_array_builtin_t> = true;
+
+    class node_array_builtin_t final : public node_expression_t {
+        array_builtins_e   type_;
+        node_expression_t* array_;
+        node_expression_t* value_; // only for push
+
+    private:
+        static int get_level(const analyze_t& value) {
+            return value.type == node_type_e::ARRAY ? value.value->level() : 0;
+        }
+
+        void expect_pushable(const analyze_t& elem, const analyze_t& value, analyze_params_t& params) const {
+            general_type_e elem_type  = to_general_type(elem.type);
+            general_type_e value_type = to_general_type(value.type);
+            if (elem_type != value_type)
+                throw error_analyze_t{value_->loc(), params.program_str,
+                                        "wrong types in push: " + type2str(value_type)
+                                      + " cannot be pushed to array of " + type2str(elem_type)};
+
+            int elem_level  = get_level(elem);
+            int value_level = get_level(value);
+            if (elem_level != value_level)
+                throw error_analyze_t{value_->loc(), params.program_str,
+                                        "wrong levels of arrays in push: " + std::to_string(value_level)
+                                      + " levels of array nesting cannot be pushed to array of "
+                                      + std::to_string(elem_level) + " levels of array nesting"};
+        }
+
+        // resized array may be element of variable by unknown index, so arrays on its depth are resized
+        void analyze_resize(node_array_t* array, analyze_params_t& params) const {
+            params.ranges.forget_sizes();
+            auto* lvalue = dynamic_cast<node_lvalue_t*>(array_);
+            if (!lvalue) {
+                array->analyze_resize(0, node_loc_t::loc(), params);
+                return;
+            }
+
+            auto [root, depth] = lvalue->analyze_root();
+            static_cast<node_array_t*>(root.value)->analyze_resize(depth, node_loc_t::loc(), params);
+        }
+
+    public:
+        node_array_builtin_t(const location_t& loc, array_builtins_e type, node_expression_t* array,
+                             node_expression_t* value = nullptr)
+        : node_expression_t(loc), type_(type), array_(array), value_(value) {
+            assert(array_);
+            assert((type_ == array_builtins_e::PUSH) == (value_ != nullptr));
+        }
+
+        execute_t execute(execute_params_t& params) override {
+            execute_t array = params.evaluate(array_);
+            if (!params.is_executed())
+                return {};
+
+            execute_t value;
+            if (value_) {
+                value = params.evaluate(value_);
+                if (!params.is_executed())
+                    return {};
+            }
+
+            if (type_ == array_builtins_e::LEN && array.type == node_type_e::MAP)
+                return make_number(static_cast<node_map_t*>(array.value)->size());
+
+            expect_types_eq(array.type, node_type_e::ARRAY, node_loc_t::loc(), params);
+            auto* node = static_cast<node_array_t*>(array.value);
+            switch (type_) {
+                case array_builtins_e::PUSH: return make_number(node->push(value, node_loc_t::loc(), params));
+                case array_builtins_e::POP:  return node->pop(node_loc_t::loc(), params);
+                case array_builtins_e::LEN:  return make_number(node->size());
+                default: throw error_location_t{node_loc_t::loc(), params.program_str,
+                                                "attempt to use unknown array builtin"};
+            }
+        }
+
+        analyze_t analyze(analyze_params_t& params) override {
+            analyze_t array = array_->analyze(params);
+            if (type_ == array_builtins_e::LEN && array.type == node_type_e::MAP)
+                return make_number(0, params, node_loc_t::loc(), false);
+
+            expect_types_eq(array.type, node_type_e::ARRAY, array_->loc(), params);
+            auto* node = static_cast<node_array_t*>(array.value);
+            analyze_t elem = node->analyze_element(node_loc_t::loc(), params);
+
+            if (value_)
+                expect_pushable(elem, value_->analyze(params), params);
+
+            if (type_ == array_builtins_e::POP) {
+                analyze_resize(node, params);
+                return elem;
+            }
+            if (type_ == array_builtins_e::PUSH)
+                analyze_resize(node, params);
+            return make_number(0, params, node_loc_t::loc(), false);
+        }
+
+        // size of array is bound of index, while range analysis knows it
+        range_value_t range(analyze_params_t& params) const override {
+            range_value_t result;
+            if (type_ != array_builtins_e::LEN)
+                return result;
+
+            result.is_non_negative = true;
+            std::vector<range_bound_t> sizes = array_->range(params).sizes;
+            if (!sizes.empty())
+                result.bound = sizes.front();
+            return result;
+        }
+
+        node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
+            return params.buf->add_node<node_array_builtin_t>(node_loc_t::loc(), type_, array_->copy(params, parent),
+                                                              value_ ? value_->copy(params, parent) : nullptr);
+        }
+
+        void compile(compile_params_t& params) const override {
+            array_->compile(params);
+            if (value_)
+                value_->compile(params);
+            params.emit(to_opcode(type_), this);
+        }
+
+        bool can_pause() const override { return array_->is_pausable() || (value_ && value_->is_pausable()); }
+
+        void set_predict(bool value) override {
+            array_->set_predict(value);
+            if (value_)
+                value_->set_predict(value);
+        }
+
+        static_assert(releases_nothing_v<node_expression_t, decltype(type_), decltype(array_), decltype(value_)>);
+    };
+}
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "ParaCL/nodes/lvalue.hpp"
 
 namespace paracl {
+    class node_assign_t;
+    template <> inline constexpr bool is_arena_only_v<node_assign_t> = true;
+
     class node_assign_t final : public node_expression_t {
         node_lvalue_t*     lvalue_;
         node_expression_t* rvalue_;
@@ -15,15 +18,22 @@ namespace paracl {
         }
 
         execute_t execute(execute_params_t& params) override {
-            execute_t rvalue_result = rvalue_->execute(params);
+            execute_t rvalue_result = params.evaluate(rvalue_);
             if (!params.is_executed())
                 return {};
             
             return lvalue_->set_value(rvalue_result, params);
         }
 
+        // facts about value are known only if they are not changed during its evaluation
         analyze_t analyze(analyze_params_t& params) override {
-            return lvalue_->set_value_analyze(rvalue_->analyze(params), params, node_loc_t::loc());
+            int version = params.ranges.version();
+            analyze_t rvalue = rvalue_->analyze(params);
+            range_value_t range = params.ranges.version() == version ? rvalue_->range(params) : range_value_t{};
+
+            analyze_t result = lvalue_->set_value_analyze(rvalue, params, node_loc_t::loc());
+            lvalue_->assume_range(range, params);
+            return result;
         }
 
         node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
@@ -33,6 +43,15 @@ namespace paracl {
                                                 rvalue_->copy(params, parent));
         }
 
+        void compile(compile_params_t& params) const override {
+            rvalue_->compile(params);
+            lvalue_->compile_set(params);
+        }
+
+        bool can_pause() const override { return lvalue_->is_pausable() || rvalue_->is_pausable(); }
+
         void set_predict(bool value) override { lvalue_->set_predict(value); }
+
+        static_assert(releases_nothing_v<node_expression_t, decltype(lvalue_), decltype(rvalue_)>);
     };
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
-#include "ParaCL/nodes/common.hpp"
+#include "ParaCL/nodes/lvalue.hpp"
+#include "ParaCL/nodes/simple_types.hpp"
+
+#include <cstdint>
+#include <functional>
 
 namespace paracl {
     enum class binary_operators_e {
@@ -20,17 +24,178 @@ namespace paracl {
         DIV,
         MOD
     };
+
+    inline opcode_e to_opcode(binary_operators_e type) {
+        switch (type) {
+            case binary_operators_e::EQ:  return opcode_e::EQ;
+            case binary_operators_e::NE:  return opcode_e::NE;
+            case binary_operators_e::LE:  return opcode_e::LE;
+            case binary_operators_e::GE:  return opcode_e::GE;
+            case binary_operators_e::LT:  return opcode_e::LT;
+            case binary_operators_e::GT:  return opcode_e::GT;
+            case binary_operators_e::OR:  return opcode_e::OR_LEFT;
+            case binary_operators_e::AND: return opcode_e::AND_LEFT;
+            case binary_operators_e::ADD: return opcode_e::ADD;
+            case binary_operators_e::SUB: return opcode_e::SUB;
+            case binary_operators_e::MUL: return opcode_e::MUL;
+            case binary_operators_e::DIV: return opcode_e::DIV;
+            case binary_operators_e::MOD: return opcode_e::MOD;
+            default: throw error_t{str_red("failed to_opcode(): unknown binary operator")};
+        }
+    }
+
+    class node_bin_op_t;
+    template <> inline constexpr bool is_arena_only_v<node_bin_op_t> = true;
+
     class node_bin_op_t final : public node_expression_t {
+        // operand of quickened operator, variable and number are read without virtual calls
+        enum class operand_kind_e : uint8_t { NODE, VARIABLE, NUMBER };
+
+        using quick_execute_t = execute_t (*)(node_bin_op_t&, execute_params_t&);
+
         binary_operators_e type_;
+        operand_kind_e left_kind_  = operand_kind_e::NODE;
+        operand_kind_e right_kind_ = operand_kind_e::NODE;
         node_expression_t* left_;
         node_expression_t* right_;
 
+        // after first execution with integer operands node runs specialized version,
+        // it is used only for expressions without calls, which are evaluated as a whole
+        quick_execute_t quick_execute_ = nullptr;
+
     private:
-        template <typename ParamsT>
-        std::optional<int> evaluate_by_left(node_number_t* result, ParamsT& params) {
-            assert(result);
+        static operand_kind_e get_operand_kind(node_expression_t* node) {
+            if (dynamic_cast<node_number_t*>(node))
+                return operand_kind_e::NUMBER;
+
+            auto* lvalue = dynamic_cast<node_lvalue_t*>(node);
+            if (lvalue && lvalue->get_scalar())
+                return operand_kind_e::VARIABLE;
+            return operand_kind_e::NODE;
+        }
+
+        static execute_t execute_operand(node_expression_t* node, operand_kind_e kind, execute_params_t& params) {
+            switch (kind) {
+                case operand_kind_e::VARIABLE:
+                    return static_cast<node_lvalue_t*>(node)->get_scalar()->execute(params);
+                case operand_kind_e::NUMBER:
+                    return make_number(static_cast<node_number_t*>(node)->get_value());
+                default:
+                    return node->execute(params);
+            }
+        }
+
+        template <typename OperatorT>
+        static execute_t execute_integers(node_bin_op_t& node, execute_params_t& params) {
+            execute_t lhs = execute_operand(node.left_, node.left_kind_, params);
+            if (lhs.type != node_type_e::INTEGER) [[unlikely]] {
+                if (lhs.type != node_type_e::ARRAY)
+                    return node.leave_integers(lhs, params);
+                execute_t rhs = execute_operand(node.right_, node.right_kind_, params);
+                return node.execute_arrays(lhs, rhs, params);
+            }
+
+            execute_t rhs = execute_operand(node.right_, node.right_kind_, params);
+            if (rhs.type != node_type_e::INTEGER) [[unlikely]] {
+                if (rhs.type != node_type_e::ARRAY)
+                    return node.leave_integers(rhs, params);
+                return node.execute_arrays(lhs, rhs, params);
+            }
+
+            return make_number(OperatorT{}(lhs.number, rhs.number));
+        }
+
+        // operand of other type gets the same checks as in generic execution
+        execute_t leave_integers(execute_t operand, execute_params_t& params) {
+            if (operand.type != node_type_e::UNDEF)
+                expect_types_eq(operand.type, node_type_e::INTEGER, node_loc_t::loc(), params);
+            return make_undef();
+        }
+
+        quick_execute_t get_quick_execute() const {
+            switch (type_) {
+                case binary_operators_e::EQ:  return &execute_integers<std::equal_to<int>>;
+                case binary_operators_e::NE:  return &execute_integers<std::not_equal_to<int>>;
+                case binary_operators_e::LE:  return &execute_integers<std::less_equal<int>>;
+                case binary_operators_e::GE:  return &execute_integers<std::greater_equal<int>>;
+                case binary_operators_e::LT:  return &execute_integers<std::less<int>>;
+                case binary_operators_e::GT:  return &execute_integers<std::greater<int>>;
+                case binary_operators_e::ADD: return &execute_integers<std::plus<int>>;
+                case binary_operators_e::SUB: return &execute_integers<std::minus<int>>;
+                case binary_operators_e::MUL: return &execute_integers<std::multiplies<int>>;
+                case binary_operators_e::DIV: return &execute_integers<std::divides<int>>;
+                case binary_operators_e::MOD: return &execute_integers<std::modulus<int>>;
+                default: return nullptr; // || and && skip right operand by value of left one
+            }
+        }
+
+        void quicken() {
+            quick_execute_ = get_quick_execute();
+            if (!quick_execute_)
+                return;
+
+            left_kind_  = get_operand_kind(left_);
+            right_kind_ = get_operand_kind(right_);
+        }
+
+        execute_t execute_generic(execute_params_t& params) {
+            execute_t lhs = params.evaluate(left_);
+            if (lhs.type == node_type_e::UNDEF || !params.is_executed())
+                return make_undef();
+
+            if (lhs.type == node_type_e::ARRAY && !is_logical()) {
+                execute_t rhs = params.evaluate(right_);
+                if (!params.is_executed())
+                    return make_undef();
+                return execute_arrays(lhs, rhs, params);
+            }
+
+            expect_types_eq(lhs.type, node_type_e::INTEGER, node_loc_t::loc(), params);
+            if (auto value_by_left = evaluate_by_left(lhs.number, params))
+                return make_number(*value_by_left);
+
+            execute_t rhs = params.evaluate(right_);
+            if (rhs.type == node_type_e::UNDEF || !params.is_executed())
+                return make_undef();
+
+            if (rhs.type == node_type_e::ARRAY && !is_logical())
+                return execute_arrays(lhs, rhs, params);
+
+            expect_types_eq(rhs.type, node_type_e::INTEGER, node_loc_t::loc(), params);
+            return make_number(evaluate(lhs.number, rhs.number, params));
+        }
 
-            int value = result->get_value();
+        // || and && take only integers, other operators are applied to elements of arrays
+        bool is_logical() const noexcept {
+            return type_ == binary_operators_e::OR || type_ == binary_operators_e::AND;
+        }
+
+        execute_t execute_arrays(const execute_t& lhs, const execute_t& rhs, execute_params_t& params) {
+            if (rhs.type == node_type_e::UNDEF)
+                return make_undef();
+            return elementwise(lhs, rhs, to_simd(),
+                               [&](int l_value, int r_value) { return evaluate(l_value, r_value, params); },
+                               node_loc_t::loc(), params);
+        }
+
+        // division has no vector instruction, its elements are divided one by one
+        std::optional<simd_op_e> to_simd() const noexcept {
+            switch (type_) {
+                case binary_operators_e::EQ:  return simd_op_e::EQ;
+                case binary_operators_e::NE:  return simd_op_e::NE;
+                case binary_operators_e::LE:  return simd_op_e::LE;
+                case binary_operators_e::GE:  return simd_op_e::GE;
+                case binary_operators_e::LT:  return simd_op_e::LT;
+                case binary_operators_e::GT:  return simd_op_e::GT;
+                case binary_operators_e::ADD: return simd_op_e::ADD;
+                case binary_operators_e::SUB: return simd_op_e::SUB;
+                case binary_operators_e::MUL: return simd_op_e::MUL;
+                default: return std::nullopt;
+            }
+        }
+
+        template <typename ParamsT>
+        std::optional<int> evaluate_by_left(int value, ParamsT& params) {
             switch (type_) {
                 case binary_operators_e::OR:  
                     return  value ? std::optional<int>{value} : std::nullopt;
@@ -57,12 +222,7 @@ namespace paracl {
         }
 
         template <typename ParamsT>
-        int evaluate(node_number_t* l_result, node_number_t* r_result, ParamsT& params) {
-            assert(l_result);
-            assert(r_result);
-
-            int LHS = l_result->get_value();
-            int RHS = r_result->get_value();
+        int evaluate(int LHS, int RHS, ParamsT& params) {
             switch (type_) {
                 case binary_operators_e::EQ: return LHS == RHS;
                 case binary_operators_e::NE: return LHS != RHS;
@@ -84,24 +244,31 @@ namespace paracl {
             }
         }
 
-        node_number_t* execute_node(node_expression_t* node, execute_params_t& params) {
-            execute_t result = node->execute(params);
-            if (result.type == node_type_e::UNDEF || !params.is_executed())
-                return nullptr;
-            return static_cast<node_number_t*>(result.value);
-        }
-
         std::pair<analyze_t, node_number_t*> analyze_node(node_expression_t* node, analyze_params_t& params) {
             analyze_t result = node->analyze(params);
+            expect_types_ne(result.type, node_type_e::MAP, node_loc_t::loc(), params);
 
             if (result.type == node_type_e::UNDEF || result.type == node_type_e::INPUT)
                 return {result, nullptr};
 
+            if (result.type == node_type_e::ARRAY && !is_logical())
+                return {result, nullptr};
+
             expect_types_ne(result.type, node_type_e::ARRAY, node_loc_t::loc(), params);
 
             return {result, static_cast<node_number_t*>(result.value)};
         }
 
+        // sizes of arrays are known only at execution, so result is array of unknown size,
+        // which elements are like elements of array operand
+        analyze_t analyze_arrays(const analyze_t& lhs, const analyze_t& rhs, analyze_params_t& params) {
+            const analyze_t& array = lhs.type == node_type_e::ARRAY ? lhs : rhs;
+            const analyze_t& other = lhs.type == node_type_e::ARRAY ? rhs : lhs;
+            expect_types_ne(other.type, node_type_e::FUNCTION, node_loc_t::loc(), params);
+            analyze_t elem = static_cast<node_array_t*>(array.value)->analyze_element(node_loc_t::loc(), params);
+            return analyze_unknown_array(node_loc_t::loc(), elem, nullptr, params);
+        }
+
     public:
         node_bin_op_t(const location_t& loc, binary_operators_e type,
                       node_expression_t* left, node_expression_t* right)
@@ -111,32 +278,40 @@ namespace paracl {
         }
 
         execute_t execute(execute_params_t& params) override {
-            node_number_t* l_value = execute_node(left_, params);
-            if (!l_value) return make_undef(params, node_loc_t::loc());
-
-            if (auto value_by_left = evaluate_by_left(l_value, params))
-                return make_number(*value_by_left, params, node_loc_t::loc());
+            if (!params.is_atomic())
+                return execute_generic(params);
 
-            node_number_t* r_value = execute_node(right_, params);
-            if (!r_value) return make_undef(params, node_loc_t::loc());
+            if (quick_execute_) [[likely]]
+                return quick_execute_(*this, params);
 
-            return make_number(evaluate(l_value, r_value, params), params, node_loc_t::loc());
+            execute_t result = execute_generic(params);
+            if (result.type == node_type_e::INTEGER)
+                quicken();
+            return result;
         }
 
         analyze_t analyze(analyze_params_t& params) override {
             auto [a_l_result, l_value] = analyze_node(left_, params);
+            if (a_l_result.type == node_type_e::ARRAY ||
+                (a_l_result.type == node_type_e::INPUT && !is_logical())) {
+                auto [a_r_result, r_value] = analyze_node(right_, params);
+                if (a_r_result.type == node_type_e::ARRAY || a_l_result.type == node_type_e::ARRAY)
+                    return a_r_result.type == node_type_e::UNDEF ? a_r_result
+                                                                 : analyze_arrays(a_l_result, a_r_result, params);
+                return a_l_result;
+            }
             if (!l_value) return a_l_result;
 
-            if (auto value_by_left = evaluate_by_left(l_value, params))
-                return analyze_t{make_number(*value_by_left, params, node_loc_t::loc()), a_l_result.is_constexpr};
+            if (auto value_by_left = evaluate_by_left(l_value->get_value(), params))
+                return make_number(*value_by_left, params, node_loc_t::loc(), a_l_result.is_constexpr);
 
             auto [a_r_result, r_value] = analyze_node(right_, params);
+            if (a_r_result.type == node_type_e::ARRAY)
+                return analyze_arrays(a_l_result, a_r_result, params);
             if (!r_value) return a_r_result;
 
-            return analyze_t{
-                make_number(evaluate(l_value, r_value, params), params, node_loc_t::loc()),
-                a_l_result.is_constexpr & a_r_result.is_constexpr
-            };
+            return make_number(evaluate(l_value->get_value(), r_value->get_value(), params),
+                               params, node_loc_t::loc(), a_l_result.is_constexpr & a_r_result.is_constexpr);
         }
 
         node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
@@ -145,9 +320,87 @@ namespace paracl {
                                                 left_->copy(params, parent), right_->copy(params, parent));
         }
 
+        void compile(compile_params_t& params) const override {
+            left_->compile(params);
+
+            if (type_ == binary_operators_e::OR ||
+                type_ == binary_operators_e::AND) {
+                int jump_end = params.emit(to_opcode(type_), this);
+                right_->compile(params);
+                params.emit(opcode_e::TO_BOOL, this);
+                params.patch_jump(jump_end);
+                return;
+            }
+
+            // undef on the left skips right operand, so guard is needed only for its side effects
+            int jump_undef = params.emit(opcode_e::JUMP_IF_UNDEF, this);
+            right_->compile(params);
+            if (params.is_trivial_push(jump_undef + 1)) {
+                params.code->erase(jump_undef);
+                params.emit(to_opcode(type_), this);
+                return;
+            }
+            params.emit(to_opcode(type_), this);
+            params.patch_jump(jump_undef);
+        }
+
+        bool can_pause() const override { return left_->is_pausable() || right_->is_pausable(); }
+
         void set_predict(bool value) override {
             left_->set_predict(value);
             right_->set_predict(value);
         }
+
+        // variable plus number, e.g. step of loop
+        range_value_t range(analyze_params_t& params) const override {
+            range_value_t result;
+            if (type_ != binary_operators_e::ADD)
+                return result;
+
+            std::optional<range_bound_t> lhs = left_->range(params).bound;
+            std::optional<range_bound_t> rhs = right_->range(params).bound;
+            if (!lhs || !rhs || (lhs->variable != nullptr) == (rhs->variable != nullptr))
+                return result;
+
+            const node_t* variable = lhs->variable ? lhs->variable : rhs->variable;
+            int increment = lhs->variable ? rhs->number : lhs->number;
+            result.is_non_negative = params.ranges.can_increment(variable, increment);
+            result.increment_of    = variable;
+            return result;
+        }
+
+        // comparison of variable with variable or number bounds it
+        void assume_true(analyze_params_t& params) const override {
+            std::optional<range_bound_t> lhs = left_->range(params).bound;
+            std::optional<range_bound_t> rhs = right_->range(params).bound;
+            if (!lhs || !rhs)
+                return;
+
+            binary_operators_e type = type_;
+            if (type == binary_operators_e::GT || type == binary_operators_e::GE) {
+                std::swap(lhs, rhs);
+                type = type == binary_operators_e::GT ? binary_operators_e::LT : binary_operators_e::LE;
+            }
+
+            // number < variable or number <= variable
+            if (!lhs->variable && rhs->variable) {
+                int lowest = type == binary_operators_e::LT ? -1 : 0;
+                if ((type == binary_operators_e::LT || type == binary_operators_e::LE) && lhs->number >= lowest)
+                    params.ranges.add_non_negative(rhs->variable);
+                return;
+            }
+
+            if (!lhs->variable)
+                return;
+            if (type == binary_operators_e::LT)
+                params.ranges.add_less(lhs->variable, *rhs);
+            else if (type == binary_operators_e::LE && !rhs->variable &&
+                     rhs->number < std::numeric_limits<int>::max())
+                params.ranges.add_less(lhs->variable, {nullptr, rhs->number + 1});
+        }
+
+        static_assert(releases_nothing_v<node_expression_t, decltype(type_), decltype(left_kind_),
+                                         decltype(right_kind_), decltype(left_), decltype(right_),
+                                         decltype(quick_execute_)>);
     };
 }
\ No newline at end of file
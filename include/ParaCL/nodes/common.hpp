@@ -2,15 +2,26 @@
 
 #include "ParaCL/common.hpp"
 #include "ParaCL/environments.hpp"
+#include "ParaCL/vm/bytecode.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <memory_resource>
+#include <limits>
+#include <new>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <sstream>
 #include <stack>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace paracl {
@@ -114,6 +125,26 @@ namespace paracl {
 
     /* ----------------------------------------------------- */
 
+    // node, which holds only numbers and pointers to other nodes, has nothing to release,
+    // so buffer doesn't keep it for destruction. virtual destructor of node_t makes no node trivially
+    // destructible, so such node type sets this flag right after its declaration, before any use of it,
+    // and checks its bases and types of its members with releases_nothing_v at the end of its definition
+    template <typename NodeT>
+    inline constexpr bool is_arena_only_v = false;
+
+    // every type is trivially destructible or arena only node, new member with resources breaks the build
+    template <typename ...TypesT>
+    inline constexpr bool releases_nothing_v =
+        ((std::is_trivially_destructible_v<TypesT> || is_arena_only_v<TypesT>) && ...);
+
+    /* ----------------------------------------------------- */
+
+    // program is a tree of nodes linked by pointers, analyze and execute are virtual calls on them.
+    // paused statements and facts of analyze refer to nodes themselves, so tree is not flattened,
+    // flat representation dispatched by switch over opcodes is the bytecode of vm
+    class node_t;
+    template <> inline constexpr bool is_arena_only_v<node_t> = true;
+
     class node_t {
     public:
         virtual ~node_t() = default;
@@ -121,16 +152,72 @@ namespace paracl {
 
     /* ----------------------------------------------------- */
 
+    // arena of nodes: they are placed one after another in chunks, which grow geometrically,
+    // so node costs no allocation of its own. nodes, which own resources, are destroyed
+    // in reverse order of creation
     class buffer_t final {
-        std::vector<std::unique_ptr<node_t>> nodes_;
+        static constexpr size_t min_chunk_size = 4096;
+        static constexpr size_t max_chunk_size = 1 << 20;
+
+        std::pmr::memory_resource* resource_;
+        std::pmr::vector<std::pair<void*, size_t>> chunks_;
+        std::pmr::vector<node_t*> nodes_; // nodes, which are not arena only
+        std::pmr::unordered_set<std::pmr::string> names_;
+
+        void*  free_       = nullptr;
+        size_t free_size_  = 0;
+        size_t chunk_size_ = min_chunk_size;
+
+    private:
+        void* allocate(size_t size, size_t alignment) {
+            if (!std::align(alignment, size, free_, free_size_)) {
+                size_t chunk_size = std::max(chunk_size_, size + alignment);
+                free_ = resource_->allocate(chunk_size, alignof(std::max_align_t));
+                chunks_.emplace_back(free_, chunk_size);
+                chunk_size_ = std::min(2 * chunk_size_, max_chunk_size);
+
+                free_size_ = chunk_size;
+                std::align(alignment, size, free_, free_size_);
+            }
+
+            void* memory = free_;
+            free_       = static_cast<std::byte*>(free_) + size;
+            free_size_ -= size;
+            return memory;
+        }
 
     public:
+        explicit buffer_t(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : resource_(resource), chunks_(resource), nodes_(resource), names_(resource) { assert(resource_); }
+
+        buffer_t(const buffer_t&) = delete;
+        buffer_t& operator=(const buffer_t&) = delete;
+
         template <typename NodeT, typename ...ArgsT>
         NodeT* add_node(ArgsT&&... args) {
-            std::unique_ptr new_node = std::make_unique<NodeT>(std::forward<ArgsT>(args)...);
-            nodes_.emplace_back(std::move(new_node));
-            return static_cast<NodeT*>(nodes_.back().get());
+            static_assert(std::is_base_of_v<node_t, NodeT>);
+            NodeT* node = new (allocate(sizeof(NodeT), alignof(NodeT))) NodeT(std::forward<ArgsT>(args)...);
+            if constexpr (!is_arena_only_v<NodeT>)
+                nodes_.push_back(node);
+            return node;
         }
+
+        // names of variables and functions are stored once, so nodes and their copies keep views of them
+        std::string_view intern(std::string_view name) { return *names_.emplace(name).first; }
+
+        void clear() noexcept {
+            std::for_each(nodes_.rbegin(), nodes_.rend(), [](node_t* node) { node->~node_t(); });
+            nodes_.clear();
+            names_.clear();
+            for (auto [chunk, size] : chunks_)
+                resource_->deallocate(chunk, size, alignof(std::max_align_t));
+            chunks_.clear();
+            free_       = nullptr;
+            free_size_  = 0;
+            chunk_size_ = min_chunk_size;
+        }
+
+        ~buffer_t() { clear(); }
     };
 
     /* ----------------------------------------------------- */
@@ -145,7 +232,6 @@ namespace paracl {
         node_loc_t() {}
         node_loc_t(const location_t& loc) : loc_(loc) {}
         location_t loc() const { return loc_; }
-        virtual ~node_loc_t() = default;
     };
     /* ----------------------------------------------------- */
 
@@ -154,16 +240,62 @@ namespace paracl {
     class  scope_base_t;
     class  execute_params_t;
     class  analyze_params_t;
+    class  compile_params_t;
     struct copy_params_t;
 
+    // size of array or bound of index: value of variable or number, if variable is nullptr
+    struct range_bound_t final {
+        const node_t* variable = nullptr;
+        int number = 0;
+
+        bool operator==(const range_bound_t&) const = default;
+    };
+
+    // what range analysis knows about value of expression before it is assigned
+    struct range_value_t final {
+        bool is_non_negative = false;
+        const node_t* increment_of = nullptr;  // value is this variable plus non negative number
+        std::optional<range_bound_t> bound;    // value itself, if it is variable or number
+        std::vector<range_bound_t>   sizes;    // sizes of array from the outer level of nesting
+    };
+
+    class node_expression_t;
+    template <> inline constexpr bool is_arena_only_v<node_expression_t> = true;
+
     class node_expression_t : public node_t,
                               public node_loc_t {
+        mutable int is_pausable_ = -1;
+
     public:
         node_expression_t(const location_t& loc) : node_loc_t(loc) {}
+
+        // expression can insert statements and wait for them: function call or scope with return
+        virtual bool can_pause() const = 0;
+
+        bool is_pausable() const {
+            if (is_pausable_ < 0)
+                is_pausable_ = can_pause();
+            return is_pausable_;
+        }
+
         virtual execute_t execute(execute_params_t& params) = 0;
         virtual analyze_t analyze(analyze_params_t& params) = 0;
         virtual void set_predict(bool value) = 0;
         virtual node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const = 0;
+        virtual void compile(compile_params_t& params) const = 0;
+
+        // value of expression is result of function, so call in it may replace caller
+        virtual void mark_tail_calls() {}
+
+        virtual range_value_t range(analyze_params_t& params) const { return {}; }
+
+        // value of literal, which is known without evaluation
+        virtual std::optional<int> constant() const { return std::nullopt; }
+
+        // facts, which follow from true value of condition, are added to range analysis
+        virtual void assume_true(analyze_params_t& params) const {}
+
+        static_assert(releases_nothing_v<node_t, node_loc_t, decltype(is_pausable_)>);
     };
 
     /* ----------------------------------------------------- */
@@ -171,7 +303,8 @@ namespace paracl {
     enum class general_type_e {
         INTEGER,
         ARRAY,
-        FUNCTION
+        FUNCTION,
+        MAP
     };
 
     inline std::string type2str(general_type_e type) {
@@ -179,24 +312,62 @@ namespace paracl {
             case general_type_e::INTEGER:  return "integer";
             case general_type_e::ARRAY:    return "array";
             case general_type_e::FUNCTION: return "function";
+            case general_type_e::MAP:      return "map";
             default:                       return "unknown type";
         }
     }
 
+    class value_heap_t;
+
+    // node, which refers to values of execution, e.g. array or variable. values, which execution
+    // creates, are owned by heap and released, when collection doesn't reach them
+    class heap_node_t {
+        friend class value_heap_t;
+
+        uint32_t epoch_   = 0; // collection, which has reached node last
+        uint32_t root_of_ = 0; // heap, which keeps node as root
+
+    protected:
+        // values, which node refers to, are reached
+        virtual void trace(value_heap_t& heap) = 0;
+
+    public:
+        // values kept by node, few big arrays are collected by count of them
+        virtual size_t count_values() const noexcept { return 0; }
+
+        virtual ~heap_node_t() = default;
+    };
+
+    /* ----------------------------------------------------- */
+
+    class node_type_t;
+    template <> inline constexpr bool is_arena_only_v<node_type_t> = true;
+
     class node_type_t : public node_expression_t {
     public:
         node_type_t(const location_t& loc) : node_expression_t(loc) {}
-        virtual void print(execute_params_t& params) = 0;
+        virtual void print(execute_params_t& params) = 0; // without end of line, value may be element of array
         virtual int  level() const = 0;
         void set_predict(bool value) override {}
+
+        // values without references to other values are not traced by collection
+        virtual heap_node_t* heap_node() noexcept { return nullptr; }
+
+        static_assert(releases_nothing_v<node_expression_t>);
     };
 
     /* ----------------------------------------------------- */
 
+    class node_simple_type_t;
+    template <> inline constexpr bool is_arena_only_v<node_simple_type_t> = true;
+
     class node_simple_type_t : public node_type_t {
     public:
         node_simple_type_t(const location_t& loc) : node_type_t(loc) {}
         int level() const override { return 0; };
+        bool can_pause() const override { return false; }
+
+        static_assert(releases_nothing_v<node_type_t>);
     };
 
     /* ----------------------------------------------------- */
@@ -206,7 +377,8 @@ namespace paracl {
         UNDEF,
         ARRAY,
         INPUT,
-        FUNCTION
+        FUNCTION,
+        MAP
     };
 
     inline std::string type2str(node_type_e type) {
@@ -216,6 +388,7 @@ namespace paracl {
             case node_type_e::INPUT:    return "number";
             case node_type_e::ARRAY:    return "array";
             case node_type_e::FUNCTION: return "function";
+            case node_type_e::MAP:      return "map";
             default:                    return "unknown type";
         }
     }
@@ -227,31 +400,51 @@ namespace paracl {
             case node_type_e::INPUT:    return general_type_e::INTEGER;
             case node_type_e::ARRAY:    return general_type_e::ARRAY;
             case node_type_e::FUNCTION: return general_type_e::FUNCTION;
+            case node_type_e::MAP:      return general_type_e::MAP;
             default:                    throw error_t{str_red("failed to_general_type(): unknown type")};
         }
     }
 
     struct execute_t final {
-        node_type_e  type;
-        node_type_t* value = nullptr;
+        node_type_e type     = node_type_e::UNDEF;
+        bool        is_empty = true; // expression has no value, e.g. fork without else branch
+        union {
+            int          number;         // integers and undef are unboxed
+            node_type_t* value = nullptr; // arrays, functions and maps
+        };
+
+    public:
+        execute_t() {}
+        execute_t(node_type_e type_) : type(type_), is_empty(false) {}
+        explicit execute_t(int number_) : type(node_type_e::INTEGER), is_empty(false), number(number_) {}
+        execute_t(node_type_e type_, node_type_t* value_)
+        : type(type_), is_empty(false), value(value_) { assert(value); }
+
+        bool is_boxed() const noexcept {
+            return !is_empty && (type == node_type_e::ARRAY || type == node_type_e::FUNCTION ||
+                                 type == node_type_e::MAP);
+        }
     };
 
     /* ----------------------------------------------------- */
 
-    template <typename ElemT>
-    class stack_t final : public std::stack<ElemT> {
+    // vector keeps its capacity, when stack shrinks, unlike blocks of deque
+    template <typename ElemT, typename BaseT = std::stack<ElemT, std::pmr::vector<ElemT>>>
+    class stack_t final : public BaseT {
     public:
-        using std::stack<ElemT>::top;
-        using std::stack<ElemT>::pop;
-        using std::stack<ElemT>::emplace;
-        using std::stack<ElemT>::size;
-        using std::stack<ElemT>::empty;
+        stack_t() = default;
+        explicit stack_t(std::pmr::memory_resource* resource) : BaseT(std::pmr::vector<ElemT>{resource}) {}
+
+        using BaseT::top;
+        using BaseT::pop;
+        using BaseT::emplace;
+        using BaseT::size;
+        using BaseT::empty;
 
         template <std::input_iterator IterT>
-        void push_values(IterT begin, IterT end) {
-            for (auto it = begin; it != end; ++it)
-                emplace(*it);
-        }
+        void push_values(IterT begin, IterT end) { BaseT::c.insert(BaseT::c.end(), begin, end); }
+
+        std::span<const ElemT> values() const noexcept { return BaseT::c; }
 
         ElemT pop_value() {
             if (empty())
@@ -282,31 +475,36 @@ namespace paracl {
 
     struct analyze_t final {
         node_type_e  type;
-        node_type_t* value = nullptr;
         bool         is_constexpr = true;
+        node_type_t* value = nullptr;
 
     public:
         analyze_t() {}
         analyze_t(bool is_constexpr_) : is_constexpr(is_constexpr_) {}
         analyze_t(node_type_e type_, node_type_t* value_) : type(type_), value(value_) { assert(value); }
         analyze_t(node_type_e type_, node_type_t* value_, int is_constexpr_)
-        : type(type_), value(value_), is_constexpr(is_constexpr_) { assert(value); }
-
-        explicit analyze_t(execute_t e_value, int is_constexpr_)
-        : type(e_value.type), value(e_value.value), is_constexpr(is_constexpr_) { assert(value); }
+        : type(type_), is_constexpr(is_constexpr_), value(value_) { assert(value); }
     };
 
     /* ----------------------------------------------------- */
 
+    class node_interpretable_t;
+    template <> inline constexpr bool is_arena_only_v<node_interpretable_t> = true;
+
     class node_interpretable_t : public node_t,
                                  public node_loc_t {
     public:
         node_interpretable_t(const location_t& loc) : node_loc_t(loc) {}
         virtual void execute(execute_params_t& params) = 0;
+
+        static_assert(releases_nothing_v<node_t, node_loc_t>);
     };
 
     /* ----------------------------------------------------- */
 
+    class node_statement_t;
+    template <> inline constexpr bool is_arena_only_v<node_statement_t> = true;
+
     class node_statement_t : public node_interpretable_t {
     public:
         node_statement_t(const location_t& loc) : node_interpretable_t(loc) {}
@@ -314,14 +512,25 @@ namespace paracl {
         virtual void set_predict(bool value) = 0;
         virtual node_statement_t* copy(copy_params_t& params, scope_base_t* parent) const = 0;
         virtual node_expression_t* to_expression(copy_params_t& params, scope_base_t* parent) const = 0;
+        virtual void compile(compile_params_t& params) const = 0;
+
+        // returns of statement are returns of function
+        virtual void mark_tail_calls() {}
+
+        static_assert(releases_nothing_v<node_interpretable_t>);
     };
 
+    class node_strong_statement_t;
+    template <> inline constexpr bool is_arena_only_v<node_strong_statement_t> = true;
+
     class node_strong_statement_t : public node_statement_t {
     public:
         node_strong_statement_t(const location_t& loc) : node_statement_t(loc) {}
         node_expression_t* to_expression(copy_params_t& params, scope_base_t* parent) const override {
             return nullptr;
         }
+
+        static_assert(releases_nothing_v<node_statement_t>);
     };
 
     /* ----------------------------------------------------- */
@@ -335,13 +544,13 @@ namespace paracl {
 
     /* ----------------------------------------------------- */
 
+    // name is owned by buffer, which interned it, or is literal, so it outlives copies of node
     class id_t {
-        std::string id_;
+        std::string_view id_;
 
     public:
         id_t(std::string_view id) : id_(id) {}
         std::string_view get_name() const { return id_; }
-        virtual ~id_t() = default;
     };
 
     /* ----------------------------------------------------- */
@@ -384,15 +593,16 @@ namespace paracl {
 
     /* ----------------------------------------------------- */
 
+    class node_empty_interpretable_t;
+    template <> inline constexpr bool is_arena_only_v<node_empty_interpretable_t> = true;
+
     class node_empty_interpretable_t : public node_interpretable_t {
     public:
         node_empty_interpretable_t(const location_t& loc) : node_interpretable_t(loc) {}
         void execute(execute_params_t& params) override {}
-    };
 
-    inline node_interpretable_t* make_empty_interpretable(const location_t& loc, copy_params_t& params) {
-        return params.buf->add_node<node_empty_interpretable_t>(loc);
-    }
+        static_assert(releases_nothing_v<node_interpretable_t>);
+    };
 
     /* ----------------------------------------------------- */
 
@@ -421,22 +631,264 @@ namespace paracl {
 
     /* ----------------------------------------------------- */
 
+    // layout of activation record of function: arguments take first slots,
+    // variables declared in function body take next ones
+    class frame_info_t final {
+        static inline int count_frames_ = 0;
+
+        int id_ = count_frames_++;
+        int count_slots_ = 0;
+
+    public:
+        int add_slot() noexcept { return count_slots_++; }
+
+        int id()          const noexcept { return id_; }
+        int count_slots() const noexcept { return count_slots_; }
+    };
+
+    /* ----------------------------------------------------- */
+
+    class frame_stack_t final {
+        std::pmr::vector<execute_t> slots_;                // frames of active calls one after another
+        std::pmr::vector<std::pmr::vector<size_t>> bases_; // beginnings of active frames of every function
+
+    public:
+        explicit frame_stack_t(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : slots_(resource), bases_(resource) {}
+
+        execute_t* push(const frame_info_t& frame) {
+            if (frame.id() >= static_cast<int>(bases_.size()))
+                bases_.resize(frame.id() + 1);
+
+            size_t base = slots_.size();
+            bases_[frame.id()].push_back(base);
+            slots_.resize(base + frame.count_slots(), execute_t{node_type_e::UNDEF});
+            return slots_.data() + base;
+        }
+
+        // calls are finished in reverse order, so popped frame is always the last one
+        void pop(const frame_info_t& frame) {
+            auto& bases = bases_[frame.id()];
+            assert(!bases.empty());
+            slots_.resize(bases.back());
+            bases.pop_back();
+        }
+
+        // frame of the most recent active call, nullptr if function is not called now
+        execute_t* find(const frame_info_t& frame, int slot) {
+            if (frame.id() >= static_cast<int>(bases_.size()) || bases_[frame.id()].empty())
+                return nullptr;
+            return slots_.data() + bases_[frame.id()].back() + slot;
+        }
+
+        std::span<const execute_t> slots() const noexcept { return slots_; }
+    };
+
+    /* ----------------------------------------------------- */
+
+    // values created by execution, e.g. slices and results of operators on arrays, as in vm.
+    // roots are holders, e.g. variables and arrays of program, which register on their first
+    // value, and values of statements in progress, so collection is safe only between statements
+    class value_heap_t final {
+        struct entry_t final {
+            heap_node_t* node;
+            void (*release)(heap_node_t*, std::pmr::memory_resource*);
+        };
+
+        std::pmr::unsynchronized_pool_resource pool_; // nodes of few sizes are reused by new ones
+        std::pmr::vector<entry_t>      nodes_;
+        std::pmr::vector<heap_node_t*> roots_;
+
+        // ids are never reused, so marks of nodes, which outlive heap, are not taken for its own
+        static inline uint32_t count_heaps_  = 0;
+        static inline uint32_t count_epochs_ = 0;
+        uint32_t id_    = ++count_heaps_;
+        uint32_t epoch_ = 0;
+
+        size_t collect_threshold_ = min_collect_threshold_;
+        size_t count_values_      = 0; // values of arrays filled at once since last collection
+        size_t values_threshold_  = min_values_threshold_;
+
+        static constexpr size_t min_collect_threshold_ = 1024;
+        static constexpr size_t min_values_threshold_  = 1 << 20;
+
+    public:
+        explicit value_heap_t(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : pool_(resource), nodes_(resource), roots_(resource) {}
+
+        value_heap_t(const value_heap_t&) = delete;
+        value_heap_t& operator=(const value_heap_t&) = delete;
+
+        template <typename NodeT, typename ...ArgsT>
+        NodeT* add_node(ArgsT&&... args) {
+            static_assert(std::is_base_of_v<heap_node_t, NodeT>);
+            NodeT* node = std::pmr::polymorphic_allocator<NodeT>{&pool_}.template new_object<NodeT>(
+                std::forward<ArgsT>(args)...
+            );
+            nodes_.push_back({node, [](heap_node_t* node, std::pmr::memory_resource* resource) {
+                std::pmr::polymorphic_allocator<NodeT>{resource}.delete_object(static_cast<NodeT*>(node));
+            }});
+            return node;
+        }
+
+        void add_root(heap_node_t* node) {
+            if (node->root_of_ == id_)
+                return;
+            node->root_of_ = id_;
+            roots_.push_back(node);
+        }
+
+        void add_values(size_t count) noexcept { count_values_ += count; }
+
+        void reach(heap_node_t* node) {
+            if (!node || node->epoch_ == epoch_)
+                return;
+            node->epoch_ = epoch_;
+            node->trace(*this);
+        }
+
+        void reach(const execute_t& value) {
+            if (value.is_boxed())
+                reach(value.value->heap_node());
+        }
+
+        bool is_full() const noexcept {
+            return nodes_.size() >= collect_threshold_ || count_values_ >= values_threshold_;
+        }
+
+        // values of statements in progress are reached by func
+        template <typename FuncT>
+        void collect(FuncT&& func) {
+            epoch_ = ++count_epochs_;
+            std::ranges::for_each(roots_, [this](heap_node_t* root) { reach(root); });
+            std::invoke(func, *this);
+
+            size_t live_values = 0;
+            std::erase_if(nodes_, [&](const entry_t& entry) {
+                if (entry.node->epoch_ == epoch_) {
+                    live_values += entry.node->count_values();
+                    return false;
+                }
+                entry.release(entry.node, &pool_);
+                return true;
+            });
+
+            collect_threshold_ = std::max(min_collect_threshold_, 2 * nodes_.size());
+            values_threshold_  = std::max(min_values_threshold_, live_values);
+            count_values_      = 0;
+        }
+
+        ~value_heap_t() {
+            std::ranges::for_each(nodes_, [this](const entry_t& entry) { entry.release(entry.node, &pool_); });
+        }
+    };
+
+    /* ----------------------------------------------------- */
+
     class node_scope_t;
+    class node_function_t;
 
     enum class execute_state_e {
         PROCESS,
         RETURN,
-        ADDED_STATEMENTS
+        ADDED_STATEMENTS,
+        TAIL_CALL
+    };
+
+    // statement keeps state of few nodes only, so linear search is faster than hashing
+    template <typename ValueT>
+    class step_table_t final {
+        std::pmr::vector<std::pair<const node_t*, ValueT>> entries_;
+
+    public:
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        step_table_t() = default;
+        explicit step_table_t(const allocator_type& alloc) : entries_(alloc) {}
+        step_table_t(const step_table_t& other, const allocator_type& alloc) : entries_(other.entries_, alloc) {}
+        step_table_t(step_table_t&& other, const allocator_type& alloc)
+        : entries_(std::move(other.entries_), alloc) {}
+
+        ValueT* find(const node_t* node) {
+            for (auto& [key, value] : entries_)
+                if (key == node)
+                    return &value;
+            return nullptr;
+        }
+
+        const ValueT* find(const node_t* node) const {
+            for (auto& [key, value] : entries_)
+                if (key == node)
+                    return &value;
+            return nullptr;
+        }
+
+        // as emplace of map: existing value is not overwritten
+        ValueT& emplace(const node_t* node, const ValueT& value) {
+            if (ValueT* existing = find(node))
+                return *existing;
+            return entries_.emplace_back(node, value).second;
+        }
+
+        template <typename FuncT>
+        void for_each(FuncT&& func) const {
+            for (auto& [key, value] : entries_)
+                func(value);
+        }
+
+        // capacity is kept, so next statements on this step don't allocate
+        void clear() noexcept { entries_.clear(); }
+
+        // tables of one run share memory resource, so their buffers are just exchanged
+        void swap(step_table_t& other) noexcept { entries_.swap(other.entries_); }
+    };
+
+    /* ----------------------------------------------------- */
+
+    // states live in vector of run memory resource and take it for their tables
+    struct step_state_t final {
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        step_table_t<execute_t> values;
+        step_table_t<int>       visits;
+        int operands_base = -1; // beginning of operands of statement
+
+        step_state_t() = default;
+        explicit step_state_t(const allocator_type& alloc) : values(alloc), visits(alloc) {}
+        step_state_t(const step_state_t& other, const allocator_type& alloc)
+        : values(other.values, alloc), visits(other.visits, alloc), operands_base(other.operands_base) {}
+        step_state_t(step_state_t&& other, const allocator_type& alloc)
+        : values(std::move(other.values), alloc), visits(std::move(other.visits), alloc),
+          operands_base(other.operands_base) {}
+
+        void clear() {
+            values.clear();
+            visits.clear();
+            operands_base = -1;
+        }
+
+        void swap(step_state_t& other) noexcept {
+            values.swap(other.values);
+            visits.swap(other.visits);
+            std::swap(operands_base, other.operands_base);
+        }
     };
 
-    class execute_params_t final : public names_visitor_t {
-        using     values_container_t = std::unordered_map<int, std::unordered_map<node_t*, execute_t>>;
-        using    visited_container_t = std::unordered_map<int, std::unordered_map<node_t*, int>>;
-        using  variables_container_t = std::unordered_map<int, std::unordered_map<node_settable_t*, execute_t>>;
-            values_container_t values;
-           visited_container_t visits;
-         variables_container_t variables;
-        std::vector<int> return_receivers;
+    /* ----------------------------------------------------- */
+
+    class execute_params_t final {
+        struct operand_t final {
+            execute_t value;
+            bool is_open = true; // expression is on the way to paused call
+        };
+
+        std::pmr::vector<step_state_t> steps_; // indexed by depth of statement in stack
+        std::pmr::vector<operand_t> operands_; // expressions of statements, which wait for calls
+        size_t operand_cursor_ = 0;
+        bool is_atomic_  = false;
+        bool is_resumed_ = false;
+        std::pmr::vector<int> return_receivers;
+        std::pmr::vector<int> calls_; // steps of frame closers of active calls
         int step = 0;
 
     public:
@@ -444,6 +896,9 @@ namespace paracl {
         std::istream* is = nullptr;
         std::string_view program_str = {};
 
+        // containers of run take memory from it, so host can drop memory of whole run at once
+        std::pmr::memory_resource* resource = nullptr;
+
         copy_params_t copy_params;
 
         execute_state_e execute_state = execute_state_e::PROCESS;
@@ -451,20 +906,37 @@ namespace paracl {
         stack_t<execute_t> stack;
         stack_t<node_interpretable_t*> statements;
 
+        frame_stack_t frames;
+
+        value_heap_t heap;
+
         bool is_visiting_prev = false;
 
+        node_function_t* tail_function = nullptr;
+
     private:
+        void release_operands(step_state_t& state) {
+            if (state.operands_base >= 0)
+                operands_.resize(state.operands_base);
+        }
+
         void update_step() {
             step = statements.size();
+            if (step >= static_cast<int>(steps_.size()))
+                steps_.resize(step + 1);
 
             if (!return_receivers.empty() && return_receivers.back() == step)
                 return_receivers.pop_back();
         }
 
     public:
-        execute_params_t(buffer_t* buf_, std::ostream* os_, std::istream* is_, std::string_view program_str_)
-        : os(os_), is(is_), program_str(program_str_) {
+        execute_params_t(buffer_t* buf_, std::ostream* os_, std::istream* is_, std::string_view program_str_,
+                         std::pmr::memory_resource* resource_ = std::pmr::get_default_resource())
+        : steps_(1, resource_), operands_(resource_), return_receivers(resource_), calls_(resource_),
+          os(os_), is(is_), program_str(program_str_), resource(resource_),
+          stack(resource_), statements(resource_), frames(resource_), heap(resource_) {
             assert(buf_);
+            assert(resource);
             assert(os);
             assert(is);
             copy_params.buf = buf_;
@@ -474,34 +946,18 @@ namespace paracl {
 
         bool is_executed() const noexcept { return execute_state == execute_state_e::PROCESS; }
 
-        template <typename IterT>
-        void upload_variables(IterT begin, IterT end) {
-            auto& step_iter = variables[step];
-            std::ranges::for_each(begin, end, [&](auto arg) {
-                step_iter.emplace(arg, arg->execute(*this));
-            });
-        }
-
-        template <typename IterT>
-        void load_variables(IterT begin, IterT end) {
-            auto& step_iter = variables[step - 1];
-            std::ranges::for_each(begin, end, [&](auto arg) {
-                auto variable_iter = step_iter.find(arg);
-                arg->set_value(variable_iter->second, *this);
-            });
-        }
+        // expression is evaluated as a whole, so its subexpressions are not recorded as operands
+        bool is_atomic() const noexcept { return is_atomic_; }
 
         std::optional<execute_t> get_evaluated(node_t* node) const {
-            if (auto step_it = values.find(step); step_it != values.end())
-                if (auto loc_it = step_it->second.find(node); loc_it != step_it->second.end())
-                    return loc_it->second;
+            if (const execute_t* value = steps_[step].values.find(node))
+                return *value;
             return std::nullopt;
         }
 
         template <typename... ArgsT>
         execute_t add_value(node_t* node, ArgsT&&... args) {
-            auto result = values[step].emplace(node, execute_t(std::forward<ArgsT>(args)...));
-            return result.first->second;
+            return steps_[step].values.emplace(node, execute_t(std::forward<ArgsT>(args)...));
         }
 
         void add_return(execute_t value) {
@@ -510,27 +966,16 @@ namespace paracl {
         }
 
         void visit(node_t* node) {
-            auto& step_map = visits[step - is_visiting_prev];
-            auto [it, inserted] = step_map.emplace(node, 1);
-            if (!inserted)
-                it->second++;
+            steps_[step - is_visiting_prev].visits.emplace(node, 0)++;
         }
 
         bool is_visited(node_t* node) const {
-            if (auto step_it = visits.find(step - is_visiting_prev); step_it != visits.end())
-                if (step_it->second.find(node) != step_it->second.end())
-                    return true;
-            return false;
-        }     
+            return steps_[step - is_visiting_prev].visits.find(node) != nullptr;
+        }
 
         int number_of_visit(node_t* node) const {
-            auto step_it = visits.find(step);
-            if (step_it != visits.end()) {
-                auto var_it = step_it->second.find(node);
-                if (var_it != step_it->second.end())
-                    return var_it->second;
-            }
-            return 0;
+            const int* count = steps_[step].visits.find(node);
+            return count ? *count : 0;
         }
 
         template <std::input_iterator IterT>
@@ -548,26 +993,92 @@ namespace paracl {
 
         void erase_statement() {
             statements.pop();
-            values.erase(step);
-            visits.erase(step);
-            variables.erase(step);
+            release_operands(steps_[step]);
+            steps_[step].clear();
             update_step();
         }
 
+        // statement starts evaluation anew
         void clear_step_values() {
-            auto step_it = values.find(step);
-            if (step_it != values.end())
-                values.erase(step_it);
+            step_state_t& state = steps_[step];
+            release_operands(state);
+            operand_cursor_ = operands_.size();
+            state.values.clear();
+            state.visits.clear();
+        }
+
+        // statement continues evaluation from operands left by previous pass
+        void begin_statement() {
+            int& base = steps_[step].operands_base;
+            if (base < 0)
+                base = operands_.size();
+            operand_cursor_ = base;
         }
 
-        template <typename MapT>
-        void shift_step(MapT& map, int old_step, int new_step) {
-            if (auto it = map.find(old_step); it != map.end()) {
-                map[new_step] = std::move(it->second);
-                map.erase(it);
+        // subexpression completed on previous pass is taken from operands, so evaluation
+        // paused by call resumes right where it stopped instead of walking whole expression
+        execute_t evaluate(node_expression_t* expr) {
+            // subexpression of expression without calls, it is recorded as a whole
+            if (is_atomic_)
+                return expr->execute(*this);
+            return evaluate_operand(expr);
+        }
+
+        execute_t evaluate_operand(node_expression_t* expr) {
+            if (!is_executed())
+                return {};
+
+            size_t position = operand_cursor_++;
+            assert(position <= operands_.size());
+            bool is_resumed = position < operands_.size();
+            if (is_resumed && !operands_[position].is_open)
+                return operands_[position].value;
+
+            if (!expr->is_pausable()) {
+                assert(position == operands_.size());
+                is_atomic_ = true;
+                execute_t result = expr->execute(*this);
+                is_atomic_ = false;
+                operands_.push_back({result, false});
+                return result;
             }
+
+            if (!is_resumed)
+                operands_.emplace_back();
+
+            is_resumed_ = is_resumed;
+            execute_t result = expr->execute(*this);
+            if (!is_executed())
+                return {};
+
+            operands_.resize(position);
+            operands_.push_back({result, false});
+            operand_cursor_ = position + 1;
+            return result;
         }
 
+        // value of statement is never replayed, so expression without calls is not recorded
+        execute_t evaluate_statement(node_expression_t* expr) {
+            if (expr->is_pausable())
+                return evaluate(expr);
+
+            is_atomic_ = true;
+            execute_t result = expr->execute(*this);
+            is_atomic_ = false;
+            return result;
+        }
+
+        // values of last evaluated operands go to stack, when all of them are ready
+        void push_operands(size_t count) {
+            assert(count <= operand_cursor_);
+            for (size_t i = operand_cursor_ - count; i < operand_cursor_; ++i)
+                stack.emplace(operands_[i].value);
+        }
+
+        // expression, which has just started to execute, continues evaluation paused on previous pass
+        bool is_resumed() const noexcept { return is_resumed_; }
+
+        // state of statement moves with it, visits stay on the old step on insertion
         void insert_statement_before(node_interpretable_t* statement) {
             auto* last_statement = statements.pop_value();
             statements.emplace(statement);
@@ -576,8 +1087,8 @@ namespace paracl {
             update_step();
             int new_step = step;
 
-            shift_step(values,    old_step, new_step);
-            shift_step(variables, old_step, new_step);
+            steps_[old_step].values.swap(steps_[new_step].values);
+            std::swap(steps_[old_step].operands_base, steps_[new_step].operands_base);
 
             if (!return_receivers.empty())
                 if (auto& last = return_receivers.back(); last == old_step)
@@ -593,13 +1104,13 @@ namespace paracl {
             int old_step = step;
             update_step();
             int new_step = step;
-            values.erase(new_step);
-            visits.erase(new_step);
-            variables.erase(new_step);
 
-            shift_step(values,    old_step, new_step);
-            shift_step(visits,    old_step, new_step);
-            shift_step(variables, old_step, new_step);
+            release_operands(steps_[new_step]);
+            steps_[new_step].clear();
+            steps_[old_step].swap(steps_[new_step]);
+
+            // visits were made by finished call, statement may call the same function again
+            steps_[new_step].visits.clear();
 
             if (!return_receivers.empty())
                 if (auto& last = return_receivers.back(); last == old_step)
@@ -617,7 +1128,224 @@ namespace paracl {
                 erase_statement();
         }
 
+        // closer of frame is on top of stack
+        void open_call()  { calls_.push_back(step); }
+        void close_call() { calls_.pop_back(); }
+
+        // statements of current call are removed with its frame, caller waits for tail call instead
+        void unwind_call() {
+            assert(!calls_.empty());
+            int closer_step = calls_.back();
+            while (step > closer_step + 1)
+                erase_statement();
+
+            for (int i = 0; i < 2; ++i) { // memory cleaner of body and frame closer
+                statements.top()->execute(*this);
+                erase_statement();
+            }
+        }
+
         buffer_t* buf() { return copy_params.buf; }
+
+        // called only between statements, when every value in progress is kept by state of run
+        void collect_garbage() {
+            if (!heap.is_full())
+                return;
+
+            heap.collect([this](value_heap_t& heap) {
+                auto reach = [&heap](const execute_t& value) { heap.reach(value); };
+                std::ranges::for_each(stack.values(), reach);
+                std::ranges::for_each(frames.slots(), reach);
+                std::ranges::for_each(operands_, [&reach](const operand_t& operand) { reach(operand.value); });
+                std::ranges::for_each(steps_, [&reach](const step_state_t& state) { state.values.for_each(reach); });
+            });
+        }
+    };
+
+    /* ----------------------------------------------------- */
+
+    inline void print_value(const execute_t& value, execute_params_t& params) {
+        switch (value.type) {
+            case node_type_e::INTEGER: *(params.os) << value.number; break;
+            case node_type_e::UNDEF:   *(params.os) << "undef"; break;
+            default:                   value.value->print(params);
+        }
+    }
+
+    /* ----------------------------------------------------- */
+
+    // facts about variables at current point of analysis: index is non negative, index is less
+    // than bound, array has size on level of nesting. Index of array proven to be in bounds by them
+    // is not checked at execution
+    class range_facts_t final {
+        enum class fact_e {
+            NON_NEGATIVE,
+            LESS,
+            SIZE
+        };
+
+        struct fact_t final {
+            fact_e        kind;
+            const node_t* variable;
+            range_bound_t bound = {};
+            int  level = 0;
+            bool is_active = true;
+        };
+
+        // proven index and facts of its proof
+        struct site_t final {
+            uint8_t* unproven;
+            uint8_t  mask;
+            std::array<int, 3> facts;
+        };
+
+        std::vector<fact_t> facts_;
+        std::vector<site_t> sites_;   // proofs inside of open regions
+        int count_regions_ = 0;
+        int version_ = 0;             // number of assignments, which are seen by analysis
+
+    public:
+        struct region_t final {
+            int first_fact;
+            int first_site;
+        };
+
+    private:
+        int find(fact_e kind, const node_t* variable, int level = 0) const {
+            for (int i = facts_.size() - 1; i >= 0; --i) {
+                const fact_t& fact = facts_[i];
+                if (fact.is_active && fact.kind == kind && fact.variable == variable && fact.level == level)
+                    return i;
+            }
+            return -1;
+        }
+
+        int find_less(const node_t* variable, const range_bound_t& size) const {
+            for (int i = facts_.size() - 1; i >= 0; --i) {
+                const fact_t& fact = facts_[i];
+                if (!fact.is_active || fact.kind != fact_e::LESS || fact.variable != variable)
+                    continue;
+                bool is_numbers = !fact.bound.variable && !size.variable;
+                if (fact.bound == size || (is_numbers && fact.bound.number <= size.number))
+                    return i;
+            }
+            return -1;
+        }
+
+    public:
+        // variable or element of it by count indexes gets new value
+        void assign(const node_t* variable, int count_indexes, bool is_integer) {
+            ++version_;
+            for (fact_t& fact : facts_) {
+                if (count_indexes == 0 && (fact.variable == variable || fact.bound.variable == variable))
+                    fact.is_active = false;
+
+                // nested array may be shared by other arrays, so sizes of all nested ones are unknown
+                if (count_indexes > 0 && !is_integer && fact.kind == fact_e::SIZE && fact.level > 0)
+                    fact.is_active = false;
+            }
+        }
+
+        // statements of program are skipped by analysis, so their assignments are unknown
+        void forget() {
+            ++version_;
+            std::ranges::for_each(facts_, [](fact_t& fact) { fact.is_active = false; });
+        }
+
+        // array is resized in place and may be shared by other variables, so no size is known
+        void forget_sizes() {
+            ++version_;
+            for (fact_t& fact : facts_)
+                if (fact.kind == fact_e::SIZE)
+                    fact.is_active = false;
+        }
+
+        int version() const noexcept { return version_; }
+
+        void add_non_negative(const node_t* variable) { facts_.push_back({fact_e::NON_NEGATIVE, variable}); }
+
+        // variable is increased, so fact about it, which was true before assignment, is still true
+        void keep_non_negative(const node_t* variable) {
+            for (int i = facts_.size() - 1; i >= 0; --i) {
+                if (facts_[i].kind == fact_e::NON_NEGATIVE && facts_[i].variable == variable) {
+                    facts_[i].is_active = true;
+                    return;
+                }
+            }
+        }
+
+        void add_less(const node_t* variable, const range_bound_t& bound) {
+            facts_.push_back({fact_e::LESS, variable, bound});
+        }
+
+        void add_sizes(const node_t* variable, const std::vector<range_bound_t>& sizes) {
+            for (int level = 0, end = sizes.size(); level < end; ++level)
+                facts_.push_back({fact_e::SIZE, variable, sizes[level], level});
+        }
+
+        bool is_non_negative(const node_t* variable) const { return find(fact_e::NON_NEGATIVE, variable) >= 0; }
+
+        // sum of variable and increment doesn't overflow, while variable is less than its bound
+        bool can_increment(const node_t* variable, int increment) const {
+            if (increment < 0 || !is_non_negative(variable))
+                return false;
+
+            return std::ranges::any_of(facts_, [&](const fact_t& fact) {
+                if (!fact.is_active || fact.kind != fact_e::LESS || fact.variable != variable)
+                    return false;
+                if (fact.bound.variable)
+                    return increment <= 1;
+                return fact.bound.number - 1LL + increment <= std::numeric_limits<int>::max();
+            });
+        }
+
+        std::vector<range_bound_t> sizes(const node_t* variable) const {
+            std::vector<range_bound_t> sizes;
+            for (int fact = find(fact_e::SIZE, variable); fact >= 0;
+                 fact = find(fact_e::SIZE, variable, sizes.size()))
+                sizes.push_back(facts_[fact].bound);
+            return sizes;
+        }
+
+        // index variable is in bounds of array on level of its nesting
+        bool prove(const node_t* array, int level, const node_t* index, uint8_t* unproven, uint8_t mask) {
+            int non_negative = find(fact_e::NON_NEGATIVE, index);
+            int size         = find(fact_e::SIZE, array, level);
+            if (non_negative < 0 || size < 0)
+                return false;
+
+            int less = find_less(index, facts_[size].bound);
+            if (less < 0)
+                return false;
+
+            if (count_regions_ > 0)
+                sites_.push_back({unproven, mask, {non_negative, size, less}});
+            return true;
+        }
+
+        region_t open_region() {
+            ++count_regions_;
+            return {static_cast<int>(facts_.size()), static_cast<int>(sites_.size())};
+        }
+
+        // region may be not executed, so its facts are not known after it
+        void close_branch(const region_t& region) {
+            facts_.resize(region.first_fact);
+            if (--count_regions_ == 0)
+                sites_.clear();
+        }
+
+        // body of loop is executed again after its end, so proofs inside it, which use facts
+        // from before the loop, hold only if these facts are still true
+        void close_loop(const region_t& region) {
+            for (const site_t& site : sites_ | std::views::drop(region.first_site)) {
+                if (std::ranges::any_of(site.facts, [&](int fact) {
+                        return fact < region.first_fact && !facts_[fact].is_active;
+                    }))
+                    *site.unproven |= site.mask;
+            }
+            close_branch(region);
+        }
     };
 
     /* ----------------------------------------------------- */
@@ -636,6 +1364,8 @@ namespace paracl {
 
         stack_t<analyze_t> stack;
 
+        range_facts_t ranges;
+
     public:
         analyze_params_t(buffer_t* buf_, std::string_view program_str_ = {})
         : program_str(program_str_) {
@@ -648,6 +1378,100 @@ namespace paracl {
 
     /* ----------------------------------------------------- */
 
+    class compile_params_t final {
+        struct receiver_t final {
+            const node_loc_t* source = nullptr;
+            std::vector<int>  jumps;
+        };
+
+        std::unordered_map<const node_t*, int> slots_;
+        std::unordered_map<const node_t*, int> functions_;
+        std::unordered_map<const frame_info_t*, int> frames_;
+        std::vector<receiver_t> receivers_;
+
+    public:
+        std::string_view program_str = {};
+        bytecode_t* code = nullptr;
+
+    public:
+        compile_params_t(bytecode_t* code_, std::string_view program_str_ = {})
+        : program_str(program_str_), code(code_) { assert(code); }
+
+        int emit(opcode_e op, const node_loc_t* source, int arg = 0, int extra = 0, uint8_t in_bounds = 0) {
+            return code->emit(op, source, arg, extra, in_bounds);
+        }
+
+        int add_constants(std::span<const int> constants) { return code->add_constants(constants); }
+
+        int label() const noexcept { return code->size(); }
+
+        void patch_jump(int jump) { code->patch_jump(jump, label()); }
+        void patch_jump(int jump, int target) { code->patch_jump(jump, target); }
+
+        // code since position only pushes value, without side effects and errors
+        bool is_trivial_push(int position) const {
+            if (label() != position + 1)
+                return false;
+
+            switch ((*code)[position].op) {
+                case opcode_e::PUSH_INT:
+                case opcode_e::PUSH_UNDEF:
+                case opcode_e::LOAD: return true;
+                default:             return false;
+            }
+        }
+
+        int get_slot(const node_t* variable) {
+            assert(variable);
+            auto [it, inserted] = slots_.emplace(variable, 0);
+            if (inserted)
+                it->second = code->add_slot();
+            return it->second;
+        }
+
+        // every frame takes contiguous range of slots, vm saves it during the call
+        int get_frame(const frame_info_t& frame) {
+            auto [it, inserted] = frames_.emplace(&frame, 0);
+            if (inserted)
+                it->second = code->add_slots(frame.count_slots());
+            return it->second;
+        }
+
+        int get_function(const node_t* function, std::string_view name,
+                         const frame_info_t& frame, int count_args) {
+            assert(function);
+            if (auto it = functions_.find(function); it != functions_.end())
+                return it->second;
+
+            int index = code->add_function(name, get_frame(frame), count_args, frame.count_slots());
+            functions_.emplace(function, index);
+            return index;
+        }
+
+        void open_receiver(const node_loc_t* source) { receivers_.push_back({source, {}}); }
+
+        void close_receiver() {
+            assert(!receivers_.empty());
+            for (int jump : receivers_.back().jumps)
+                patch_jump(jump);
+            receivers_.pop_back();
+        }
+
+        const node_loc_t* receiver_source(const node_loc_t* default_source) const noexcept {
+            return receivers_.empty() ? default_source : receivers_.back().source;
+        }
+
+        void emit_return(const node_loc_t* source) {
+            if (receivers_.empty()) {
+                emit(opcode_e::HALT, source);
+                return;
+            }
+            receivers_.back().jumps.push_back(emit(opcode_e::JUMP, source));
+        }
+    };
+
+    /* ----------------------------------------------------- */
+
     template <typename T>
     concept existed_types = std::same_as<T, node_type_e> || std::same_as<T, general_type_e>;
 
@@ -676,8 +1500,19 @@ namespace paracl {
             throw error_analyze_t{loc, params.program_str, "wrong type: " + type2str(result)};
     }
 
+    inline int condition_value(const execute_t& condition, const location_t& loc, execute_params_t& params) {
+        if (condition.type == node_type_e::UNDEF)
+            throw error_execute_t{loc, params.program_str, "wrong type: undef, excpected int"};
+
+        expect_types_eq(condition.type, node_type_e::INTEGER, loc, params);
+        return condition.number;
+    }
+
     /* ----------------------------------------------------- */
 
+    class node_instruction_t;
+    template <> inline constexpr bool is_arena_only_v<node_instruction_t> = true;
+
     class node_instruction_t final : public node_statement_t {
         node_expression_t* expr_;
 
@@ -686,7 +1521,7 @@ namespace paracl {
         : node_statement_t(loc), expr_(expr) { assert(expr_); }
 
         void execute(execute_params_t& params) override {
-            expr_->execute(params);
+            params.evaluate_statement(expr_);
         }
 
         void analyze(analyze_params_t& params) override {
@@ -701,6 +1536,13 @@ namespace paracl {
             return expr_;
         }
 
+        void compile(compile_params_t& params) const override {
+            expr_->compile(params);
+            params.emit(opcode_e::POP, this);
+        }
+
         void set_predict(bool value) override { expr_->set_predict(value); };
+
+        static_assert(releases_nothing_v<node_statement_t, decltype(expr_)>);
     };
 }
\ No newline at end of file
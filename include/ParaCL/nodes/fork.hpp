@@ -3,6 +3,9 @@
 #include "ParaCL/nodes/common.hpp"
 
 namespace paracl {
+    class node_fork_expr_t;
+    template <> inline constexpr bool is_arena_only_v<node_fork_expr_t> = true;
+
     class node_fork_expr_t final : public node_expression_t {
         node_expression_t* condition_;
         node_scope_return_t* body1_;
@@ -18,39 +21,38 @@ namespace paracl {
         }
 
         execute_t execute(execute_params_t& params) override {
-            if (auto result = params.get_evaluated(this))
-                return *result;
-
-            execute_t condition_result = condition_->execute(params);
+            execute_t condition_result = params.evaluate(condition_);
             if (!params.is_executed())
                 return {};
 
-            int value = static_cast<node_number_t*>(condition_result.value)->get_value();
-            execute_t result;
+            int value = condition_value(condition_result, node_loc_t::loc(), params);
             if (value)
-                result = body1_->execute(params);
+                return params.evaluate(body1_);
             else if (!body2_->empty())
-                result = body2_->execute(params);
-
-            if (params.is_executed())
-                params.add_value(this, result);
-
-            return result;
+                return params.evaluate(body2_);
+            return {};
         }
 
         analyze_t analyze(analyze_params_t& params) override {
             analyze_t result = condition_->analyze(params);
 
             expect_types_ne(result.type, node_type_e::ARRAY, node_loc_t::loc(), params);
+            expect_types_ne(result.type, node_type_e::MAP,   node_loc_t::loc(), params);
             expect_types_ne(result.type, node_type_e::UNDEF, node_loc_t::loc(), params);
 
             body1_->set_predict(false);
             body2_->set_predict(false);
 
+            auto region = params.ranges.open_region();
+            condition_->assume_true(params);
             body1_->analyze(params);
-            if (!body2_->empty())
-                body2_->analyze(params);
+            params.ranges.close_branch(region);
 
+            if (!body2_->empty()) {
+                region = params.ranges.open_region();
+                body2_->analyze(params);
+                params.ranges.close_branch(region);
+            }
             return {false};
         }
 
@@ -61,12 +63,39 @@ namespace paracl {
                                         static_cast<node_scope_return_t*>(body2_->copy(params, parent)));
         }
 
+        void compile(compile_params_t& params) const override {
+            condition_->compile(params);
+            int jump_else = params.emit(opcode_e::JUMP_IF_FALSE, this);
+            body1_->compile(params);
+            int jump_end = params.emit(opcode_e::JUMP, this);
+            params.patch_jump(jump_else);
+
+            // without else branch fork has no value, it is error of the nearest enclosing scope
+            if (!body2_->empty())
+                body2_->compile(params);
+            else
+                params.emit(opcode_e::MISSING_RETURN, params.receiver_source(this));
+            params.patch_jump(jump_end);
+        }
+
+        bool can_pause() const override { return true; }
+
+        void mark_tail_calls() override {
+            body1_->mark_tail_calls();
+            body2_->mark_tail_calls();
+        }
+
         void set_predict(bool value) override {
             body1_->set_predict(value);
             body2_->set_predict(value);
         };
+
+        static_assert(releases_nothing_v<node_expression_t, decltype(condition_), decltype(body1_), decltype(body2_)>);
     };
 
+    class node_fork_t;
+    template <> inline constexpr bool is_arena_only_v<node_fork_t> = true;
+
     class node_fork_t final : public node_statement_t {
         node_expression_t* condition_;
         node_scope_t* body1_;
@@ -85,11 +114,11 @@ namespace paracl {
             if (params.get_evaluated(this))
                 return;
 
-            execute_t result = condition_->execute(params);
+            execute_t result = params.evaluate_statement(condition_);
             if (!params.is_executed()) return;
             params.add_value(this, result);
 
-            int value = static_cast<node_number_t*>(result.value)->get_value();
+            int value = condition_value(result, node_loc_t::loc(), params);
             if (value)
                 params.insert_statement(body1_);
             else
@@ -100,13 +129,20 @@ namespace paracl {
             analyze_t result = condition_->analyze(params);
 
             expect_types_ne(result.type, node_type_e::ARRAY, node_loc_t::loc(), params);
+            expect_types_ne(result.type, node_type_e::MAP,   node_loc_t::loc(), params);
             expect_types_ne(result.type, node_type_e::UNDEF, node_loc_t::loc(), params);
 
             body1_->set_predict(false);
             body2_->set_predict(false);
 
+            auto region = params.ranges.open_region();
+            condition_->assume_true(params);
             body1_->analyze(params);
+            params.ranges.close_branch(region);
+
+            region = params.ranges.open_region();
             body2_->analyze(params);
+            params.ranges.close_branch(region);
         }
 
         node_statement_t* copy(copy_params_t& params, scope_base_t* parent) const override {
@@ -116,6 +152,26 @@ namespace paracl {
                                               static_cast<node_scope_t*>(body2_->copy(params, parent)));
         }
 
+        void compile(compile_params_t& params) const override {
+            condition_->compile(params);
+            int jump_else = params.emit(opcode_e::JUMP_IF_FALSE, this);
+            body1_->compile(params);
+            if (body2_->empty()) {
+                params.patch_jump(jump_else);
+                return;
+            }
+
+            int jump_end = params.emit(opcode_e::JUMP, this);
+            params.patch_jump(jump_else);
+            body2_->compile(params);
+            params.patch_jump(jump_end);
+        }
+
+        void mark_tail_calls() override {
+            body1_->mark_tail_calls();
+            body2_->mark_tail_calls();
+        }
+
         node_expression_t* to_expression(copy_params_t& params, scope_base_t* parent) const override {
             auto& buf = params.buf;
             return buf->add_node<node_fork_expr_t>(node_loc_t::loc(), condition_->copy(params, parent),
@@ -127,5 +183,7 @@ namespace paracl {
             body1_->set_predict(value);
             body2_->set_predict(value);
         };
+
+        static_assert(releases_nothing_v<node_statement_t, decltype(condition_), decltype(body1_), decltype(body2_)>);
     };
 }
\ No newline at end of file
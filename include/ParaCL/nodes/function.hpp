@@ -5,33 +5,34 @@
 #include <iomanip>
 
 namespace paracl {
-    class node_function_args_initializator_t final : public node_interpretable_t {
-        std::vector<node_variable_t*> args_;
+    class node_function_frame_opener_t final : public node_interpretable_t {
+        const frame_info_t* frame_;
+        int count_args_;
 
-    private:
-        node_instruction_t* make_assign_instruction(node_variable_t* var, node_expression_t* rvalue,
-                                                    buffer_t* buf) {
-            node_indexes_t* indexes = buf->add_node<node_indexes_t>(var->loc());
-            node_lvalue_t*  lvalue  = buf->add_node<node_lvalue_t> (var->loc(), var, indexes);
-            node_assign_t*  assign  = buf->add_node<node_assign_t> (var->loc(), lvalue, rvalue);
-            return buf->add_node<node_instruction_t>(assign->loc(), assign);
+    public:
+        node_function_frame_opener_t(const location_t& loc, const frame_info_t* frame, int count_args)
+        : node_interpretable_t(loc), frame_(frame), count_args_(count_args) { assert(frame_); }
+
+        // the first argument is on top of stack
+        void execute(execute_params_t& params) override {
+            execute_t* slots = params.frames.push(*frame_);
+            for (int i = 0; i < count_args_; ++i)
+                slots[i] = params.stack.pop_value();
         }
+    };
+
+    /* ----------------------------------------------------- */
+
+    class node_function_frame_closer_t final : public node_interpretable_t {
+        const frame_info_t* frame_;
 
     public:
-        node_function_args_initializator_t(const location_t& loc, const std::vector<node_variable_t*>& args)
-        : node_interpretable_t(loc), args_(args) {}
+        node_function_frame_closer_t(const location_t& loc, const frame_info_t* frame)
+        : node_interpretable_t(loc), frame_(frame) { assert(frame_); }
 
         void execute(execute_params_t& params) override {
-            if (params.is_visited(this))
-                return;
-            params.visit(this);
-
-            auto values = params.stack.pop_values(args_.size());
-            std::vector<node_interpretable_t*> instructions;
-            buffer_t* buf = params.buf();
-            for (int i = 0, end = args_.size(); i < end; ++i)
-                instructions.push_back(make_assign_instruction(args_[i], values[i].value, buf));
-            params.insert_statements(instructions.rbegin(), instructions.rend());
+            params.frames.pop(*frame_);
+            params.close_call();
         }
     };
 
@@ -60,10 +61,10 @@ namespace paracl {
             name_table.insert(name);
         }
 
-        void execute(execute_params_t& params) {
-            params.insert_statement(
-                params.buf()->add_node<node_function_args_initializator_t>(node_loc_t::loc(), args_)
-            );
+        void bind_slots(frame_info_t& frame) {
+            std::ranges::for_each(args_, [&frame](auto arg) {
+                arg->bind_slot(&frame, frame.add_slot());
+            });
         }
 
         void analyze(analyze_params_t& params) {
@@ -95,30 +96,6 @@ namespace paracl {
 
     /* ----------------------------------------------------- */
 
-    class node_stack_filler_t final : public node_interpretable_t {
-        node_expression_t* expr_;
-
-    public:
-        node_stack_filler_t(const location_t& loc, node_expression_t* expr)
-        : node_interpretable_t(loc), expr_(expr) { assert(expr_); }
-
-        void execute(execute_params_t& params) override {
-            if (auto result = params.get_evaluated(this)) {
-                params.stack.emplace(*result);
-                return;
-            }
-
-            execute_t result = expr_->execute(params);
-            if (!params.is_executed())
-                return;
-
-            params.stack.emplace(result);
-            params.add_value(this, result);
-        }
-    };
-
-    /* ----------------------------------------------------- */
-
     class node_function_call_args_t final : public node_t,
                                             public node_loc_t {
         std::vector<node_expression_t*> args_;
@@ -131,11 +108,15 @@ namespace paracl {
             args_.push_back(arg);
         }
 
-        void execute(execute_params_t& params) {
-            std::ranges::for_each(args_, [&params](auto arg) {
-                node_stack_filler_t* stack_filler = params.buf()->add_node<node_stack_filler_t>(arg->loc(), arg);
-                params.insert_statement(stack_filler);
-            });
+        // arguments are evaluated from last to first, so the first one is on top of stack
+        bool execute(execute_params_t& params) {
+            for (auto arg : std::ranges::reverse_view(args_)) {
+                params.evaluate(arg);
+                if (!params.is_executed())
+                    return false;
+            }
+            params.push_operands(args_.size());
+            return true;
         }
 
         void analyze(analyze_params_t& params) {
@@ -153,6 +134,12 @@ namespace paracl {
             });
         }
 
+        void compile(compile_params_t& params) const {
+            std::ranges::for_each(std::ranges::reverse_view(args_), [&params](auto arg) {
+                arg->compile(params);
+            });
+        }
+
         node_function_call_args_t* copy(copy_params_t& params, scope_base_t* parent) const {
             node_function_call_args_t* copy =
                 params.buf->add_node<node_function_call_args_t>(node_loc_t::loc());
@@ -172,32 +159,39 @@ namespace paracl {
                                   public id_t {
         node_function_args_t* args_;
         node_scope_return_t*  body_;
+        frame_info_t          frame_;
+
+        // stateless, so the same nodes serve all active calls
+        node_function_frame_opener_t opener_;
+        node_function_frame_closer_t closer_;
 
         static constexpr std::string_view default_function_name_prefix  = "#default_function_name_";
         static constexpr std::string_view default_function_name_postfix = "_#";
         static inline int                 default_function_name_index   = 1;
 
-    private:
-        std::string get_function_name(std::string_view id) {
-            if (id.empty()) {
-                std::ostringstream oss;
-                oss << default_function_name_prefix
-                    << std::setw(3) << std::setfill('0') << default_function_name_index++
-                    << default_function_name_postfix;
-                return oss.str();
-            }
-            return std::string(id);
+    public:
+        // name of function without name, unique in program
+        static std::string default_name() {
+            std::ostringstream oss;
+            oss << default_function_name_prefix
+                << std::setw(3) << std::setfill('0') << default_function_name_index++
+                << default_function_name_postfix;
+            return oss.str();
         }
 
-    public:
         node_function_t(const location_t& loc, node_function_args_t* args,
                         node_scope_return_t* body, std::string_view id)
-        : node_simple_type_t(loc), id_t(get_function_name(id)), args_(args), body_(body) {}
+        : node_simple_type_t(loc), id_t(id), args_(args), body_(body),
+          opener_(loc, &frame_, args->size()), closer_(loc, &frame_) {
+            assert(args_);
+            args_->bind_slots(frame_);
+        }
 
         void bind_body(node_scope_return_t* body) {
             body_ = body;
             assert(body_);
             assert(args_);
+            body_->mark_tail_calls();
         }
 
         execute_t execute(execute_params_t& params) override {
@@ -208,16 +202,14 @@ namespace paracl {
             return {node_type_e::FUNCTION, this};
         }
 
-        void upload_state(execute_params_t& params) {
-            params.upload_variables(args_->begin(), args_->end());
-        }
-
-        void load_state(execute_params_t& params) {
-            params.load_variables(args_->begin(), args_->end());
+        // evaluated arguments are on top of stack, statement takes them to the new frame
+        void open_frame(execute_params_t& params) {
+            params.insert_statement(&opener_);
         }
 
-        void args_execute(execute_params_t& params) {
-            args_->execute(params);
+        void close_frame(execute_params_t& params) {
+            params.insert_statement(&closer_);
+            params.open_call();
         }
 
         execute_t body_execute(execute_params_t& params) {
@@ -225,13 +217,21 @@ namespace paracl {
             return body_->execute(params);
         }
 
+        // frame of finished caller is already closed, its result is result of this call
+        void execute_tail(execute_params_t& params) {
+            assert(body_);
+            close_frame(params);
+            body_->enter(params);
+            open_frame(params);
+        }
+
         analyze_t real_analyze(analyze_params_t& params) {
             assert(body_);
             args_->analyze(params);
             return body_->analyze(params);
         }
 
-        void print(execute_params_t& params) override { *(params.os) << "function " << get_name() << "\n"; }
+        void print(execute_params_t& params) override { *(params.os) << "function " << get_name(); }
 
         node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
             assert(body_);
@@ -251,25 +251,36 @@ namespace paracl {
             return function_copy;
         }
 
-        size_t count_args() const { return args_->size(); }
-    };
+        void compile(compile_params_t& params) const override {
+            assert(body_);
 
-    /* ----------------------------------------------------- */
+            int index = params.get_function(this, get_name(), frame_, args_->size());
+            function_info_t& info = params.code->function(index);
+            if (info.entry < 0) {
+                int jump_over = params.emit(opcode_e::JUMP, this);
+                info.entry = params.label();
+                body_->compile(params);
+                params.emit(opcode_e::RET, this);
+                params.patch_jump(jump_over);
+            }
+            params.emit(opcode_e::PUSH_FUNCTION, this, index);
+        }
 
-    class node_function_state_loader_t final : public node_interpretable_t {
-        node_function_t* func_;
+        void compile_ref(compile_params_t& params) const {
+            int index = params.get_function(this, get_name(), frame_, args_->size());
+            params.emit(opcode_e::PUSH_FUNCTION, this, index);
+        }
 
-    public:
-        node_function_state_loader_t(const location_t& loc, node_function_t* func)
-        : node_interpretable_t(loc), func_(func) { assert(func_); }
+        size_t count_args() const { return args_->size(); }
 
-        void execute(execute_params_t& params) override {
-            func_->load_state(params);
-        }
+        frame_info_t& frame() noexcept { return frame_; }
     };
 
     /* ----------------------------------------------------- */
 
+    class node_function_call_t;
+    template <> inline constexpr bool is_arena_only_v<node_function_call_t> = true;
+
     class node_function_call_t : public node_expression_t {
         static inline int default_analyze_return = 42;
 
@@ -277,6 +288,10 @@ namespace paracl {
         node_expression_t*         function_;
         node_function_call_args_t* args_;
         bool is_call_by_name_;
+        bool is_tail_ = false;
+
+        // function called by name is known, so it is not evaluated as operand on every call
+        node_function_t* known_function_ = nullptr;
 
     private:
         void process_count_arguments(size_t cnt_args_decl, size_t cnt_args_call,
@@ -307,15 +322,17 @@ namespace paracl {
             if (!is_call_by_name_)
                 return std::nullopt;
  
-            if (params.is_name_visited(function_to_id(function_)))
-                return analyze_t{make_number(default_analyze_return, params, node_loc_t::loc()), false};
+            // body of recursive call is not analyzed again, so its assignments are unknown
+            if (params.is_name_visited(function_to_id(function_))) {
+                params.ranges.forget();
+                return make_number(default_analyze_return, params, node_loc_t::loc(), false);
+            }
 
             return std::nullopt;
         }
 
-        execute_t execute_function_body(bool is_visiting_prev, node_function_t* function,
-                                        execute_params_t& params) {
-            params.is_visiting_prev = is_visiting_prev;
+        execute_t execute_function_body(node_function_t* function, execute_params_t& params) {
+            params.is_visiting_prev = true;
             execute_t result = function->body_execute(params);
             params.is_visiting_prev = false;
             return result;
@@ -327,39 +344,40 @@ namespace paracl {
         : node_expression_t(loc), function_(function), args_(args), is_call_by_name_(is_call_by_name) {
             assert(function_);
             assert(args_);
+            if (is_call_by_name_)
+                known_function_ = static_cast<node_function_t*>(function_);
         }
 
-        execute_t execute(execute_params_t& params) override {        
-            execute_t func_value = function_->execute(params);
-            node_function_t* function = static_cast<node_function_t*>(func_value.value);
-
-            int  number_of_visit = params.number_of_visit(this);
-            bool is_prev_upload  = params.is_name_visited(function);
-
-            if (!params.is_visited(this)) {
-                params.visit(this);
-                if (is_prev_upload)
-                    function->upload_state(params);
-                function->args_execute(params);
-                args_->execute(params);
+        execute_t execute(execute_params_t& params) override {
+            if (!params.is_executed())
                 return {};
+
+            node_function_t* function = known_function_;
+            if (!function) {
+                execute_t func_value = params.evaluate(function_);
+                if (!params.is_executed())
+                    return {};
+                function = static_cast<node_function_t*>(func_value.value);
             }
-            params.visit(this);
-            params.visit_name(function_to_id(function), params.get_step());
 
-            if (!is_prev_upload)
-                function->upload_state(params);
+            if (params.is_visited(this))
+                return function->body_execute(params);
+
+            if (!args_->execute(params))
+                return {};
 
-            bool is_uploaded = (is_prev_upload && (number_of_visit == 1));
-            if (is_uploaded) {
-                params.insert_statement(
-                    params.buf()->add_node<node_function_state_loader_t>(node_loc_t::loc(), function)
-                );
+            if (is_tail_) {
+                params.tail_function = function;
+                params.execute_state = execute_state_e::TAIL_CALL;
+                return {};
             }
+            params.visit(this);
 
-            execute_t result = execute_function_body(is_uploaded, function, params);
-            if (params.is_executed())
-                params.unvisit_name(function_to_id(function), params.get_step());
+            // frame is opened above statements of body and closed below them,
+            // so rest of calling statement is evaluated in frame of caller
+            function->close_frame(params);
+            execute_t result = execute_function_body(function, params);
+            function->open_frame(params);
             return result;
         }
 
@@ -378,7 +396,10 @@ namespace paracl {
             node_function_t* function = static_cast<node_function_t*>(function_a.value);
             process_count_arguments(function->count_args(), args_->size(), params);
 
+            // body is executed again by recursive calls
+            auto region = params.ranges.open_region();
             analyze_t result = function->real_analyze(params);
+            params.ranges.close_loop(region);
             if (is_call_by_name_)
                 params.unvisit_name(function_to_id(function_));
             return result;
@@ -400,38 +421,53 @@ namespace paracl {
                                                               is_call_by_name_);
         }
 
+        void compile(compile_params_t& params) const override {
+            if (is_call_by_name_)
+                static_cast<node_function_t*>(function_)->compile_ref(params);
+            else
+                function_->compile(params);
+
+            args_->compile(params);
+            params.emit(is_tail_ ? opcode_e::TAIL_CALL : opcode_e::CALL, this, 0, args_->size());
+        }
+
+        bool can_pause() const override { return true; }
+
+        void mark_tail_calls() override { is_tail_ = true; }
+
         void set_predict(bool value) override {
             function_->set_predict(value);
             args_->set_predict(value);
         }
+
+        static_assert(releases_nothing_v<node_expression_t, decltype(function_), decltype(args_),
+                                         decltype(is_call_by_name_), decltype(is_tail_), decltype(known_function_)>);
     };
 
     /* ----------------------------------------------------- */
 
+    class node_function_call_wrapper_t;
+    template <> inline constexpr bool is_arena_only_v<node_function_call_wrapper_t> = true;
+
     class node_function_call_wrapper_t final : public node_function_call_t {
+        node_empty_interpretable_t placeholder_;
+
     public:
         node_function_call_wrapper_t(const location_t& loc, node_expression_t* function,
                                      node_function_call_args_t* args, bool is_call_by_name)
-        : node_function_call_t(loc, function, args, is_call_by_name) {}
+        : node_function_call_t(loc, function, args, is_call_by_name), placeholder_(loc) {}
 
         execute_t execute(execute_params_t& params) override {
-            if (auto result = params.get_evaluated(this))
-                return *result;
-
-            if (!params.is_visited(this)) {
-                params.visit(this);
-                params.insert_statement_before(
-                    make_empty_interpretable(node_loc_t::loc(), params.copy_params)
-                );
-            }
+            if (!params.is_resumed())
+                params.insert_statement_before(&placeholder_);
 
             params.execute_state = execute_state_e::PROCESS;
             execute_t result = node_function_call_t::execute(params);
-            if (params.is_executed()) {
+            if (params.is_executed())
                 params.erase_statement_before();
-                params.add_value(this, result);
-            }
             return result;
         }
+
+        static_assert(releases_nothing_v<node_function_call_t, decltype(placeholder_)>);
     };
 }
\ No newline at end of file
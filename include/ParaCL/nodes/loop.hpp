@@ -3,32 +3,31 @@
 #include "ParaCL/nodes/common.hpp"
 
 namespace paracl {
+    class node_loop_t;
+    template <> inline constexpr bool is_arena_only_v<node_loop_t> = true;
+
     class node_loop_t final : public node_strong_statement_t {
         node_expression_t* condition_;
         node_scope_t* body_;
 
     private:
-        void check_step_type(node_type_e type, execute_params_t& params) const {
-            if (type == node_type_e::UNDEF)
-                throw error_execute_t{node_loc_t::loc(), params.program_str,
-                                      "wrong type: undef, excpected int"};
-        }
-
         std::optional<int> step(execute_params_t& params) {
-            params.clear_step_values();
-            execute_t result = condition_->execute(params);
+            // value of loop marks finished iteration, otherwise condition waits for call
+            if (params.get_evaluated(this))
+                params.clear_step_values();
 
+            execute_t result = params.evaluate_statement(condition_);
             if (!params.is_executed())
                 return std::nullopt;
 
-            check_step_type(result.type, params);
-
-            return static_cast<node_number_t*>(result.value)->get_value();
+            params.add_value(this, result);
+            return condition_value(result, node_loc_t::loc(), params);
         }
 
         void check_condition(analyze_params_t& params) {
             analyze_t result = condition_->analyze(params);
             expect_types_ne(result.type, node_type_e::ARRAY, node_loc_t::loc(), params);
+            expect_types_ne(result.type, node_type_e::MAP,   node_loc_t::loc(), params);
             expect_types_ne(result.type, node_type_e::UNDEF, node_loc_t::loc(), params);
         }
 
@@ -40,14 +39,18 @@ namespace paracl {
         }
 
         void execute(execute_params_t& params) override {
-            if (auto condition_value = step(params); *condition_value)
+            if (auto condition_value = step(params); condition_value && *condition_value)
                 params.insert_statement(body_);
         }
 
+        // condition is evaluated after body too, so it is in region of loop
         void analyze(analyze_params_t& params) override {
+            auto region = params.ranges.open_region();
             check_condition(params);
+            condition_->assume_true(params);
             body_->set_predict(false);
             body_->analyze(params);
+            params.ranges.close_loop(region);
         }
 
         node_statement_t* copy(copy_params_t& params, scope_base_t* parent) const override {
@@ -56,8 +59,21 @@ namespace paracl {
                                               static_cast<node_scope_t*>(body_->copy(params, parent)));
         }
 
+        void compile(compile_params_t& params) const override {
+            int jump_condition = params.emit(opcode_e::JUMP, this);
+            int body = params.label();
+            body_->compile(params);
+            params.patch_jump(jump_condition);
+            condition_->compile(params);
+            params.patch_jump(params.emit(opcode_e::JUMP_IF_TRUE, this), body);
+        }
+
+        void mark_tail_calls() override { body_->mark_tail_calls(); }
+
         void set_predict(bool value) override {
             body_->set_predict(value);
         };
+
+        static_assert(releases_nothing_v<node_strong_statement_t, decltype(condition_), decltype(body_)>);
     };
 }
\ No newline at end of file
@@ -3,9 +3,45 @@
 #include "ParaCL/nodes/variable.hpp"
 
 namespace paracl {
+    class node_lvalue_t;
+    template <> inline constexpr bool is_arena_only_v<node_lvalue_t> = true;
+
     class node_lvalue_t final : public node_expression_t {
+        // way of access is chosen on first execution and is kept after it
+        enum class access_e {
+            UNKNOWN,
+            SCALAR,      // variable without indexes
+            FIXED_DEPTH, // few indexes without calls, they are evaluated without vector
+            GENERIC
+        };
+
         node_variable_t* variable_;
         node_indexes_t*  indexes_;
+        access_e access_ = access_e::UNKNOWN;
+
+    private:
+        access_e access() {
+            if (access_ != access_e::UNKNOWN) [[likely]]
+                return access_;
+
+            if (indexes_->empty())
+                access_ = access_e::SCALAR;
+            else if (!is_pausable() && indexes_->size() <= node_indexes_t::max_fixed_depth)
+                access_ = access_e::FIXED_DEPTH;
+            else
+                access_ = access_e::GENERIC;
+            return access_;
+        }
+
+        // index, which is variable proven to be in bounds of array, is not checked at execution
+        void prove_in_bounds(analyze_params_t& params) {
+            const int end = std::min<int>(indexes_->size(), node_indexes_t::max_proven_depth);
+            for (int depth = 0; depth < end; ++depth) {
+                auto* index = dynamic_cast<node_lvalue_t*>((*indexes_)[depth]);
+                bool is_scalar = index && index->variable_ && index->indexes_->empty();
+                indexes_->prove(depth, variable_, is_scalar ? index->variable_ : nullptr, params);
+            }
+        }
 
     public:
         node_lvalue_t(const location_t& loc, node_variable_t* variable, node_indexes_t* indexes)
@@ -14,24 +50,80 @@ namespace paracl {
         }
 
         execute_t execute(execute_params_t& params) override {
-            return variable_->execute(indexes_, params);
+            switch (access()) {
+                case access_e::SCALAR:
+                    return variable_->execute(params);
+
+                case access_e::FIXED_DEPTH: {
+                    node_indexes_t::fixed_indexes_t buffer;
+                    return variable_->execute(indexes_->execute(buffer, params), indexes_, params);
+                }
+
+                default:
+                    return variable_->execute(indexes_, params);
+            }
         }
 
         analyze_t analyze(analyze_params_t& params) override {
             if (!variable_)
                 throw error_declaration_t{node_loc_t::loc(), params.program_str, "undeclared variable"};
-            return variable_->analyze(indexes_, params);
+            analyze_t result = variable_->analyze(indexes_, params);
+            prove_in_bounds(params);
+            return result;
         }
 
         execute_t set_value(execute_t new_value, execute_params_t& params) {
-            return variable_->set_value(indexes_, new_value, params);
+            switch (access()) {
+                case access_e::SCALAR:
+                    return variable_->set_value(new_value, params);
+
+                case access_e::FIXED_DEPTH: {
+                    node_indexes_t::fixed_indexes_t buffer;
+                    return variable_->set_value(indexes_->execute(buffer, params), indexes_, new_value, params);
+                }
+
+                default:
+                    return variable_->set_value(indexes_, new_value, params);
+            }
+        }
+
+        // variable read by quickened operators without call of lvalue
+        node_variable_t* get_scalar() {
+            return access() == access_e::SCALAR ? variable_ : nullptr;
         }
 
         analyze_t set_value_analyze(analyze_t new_value, analyze_params_t& params,
                                     const location_t& loc_set) {
+            prove_in_bounds(params);
             return variable_->set_value_analyze(indexes_, new_value, params, loc_set);
         }
 
+        // facts about assigned value become facts about variable
+        void assume_range(const range_value_t& range, analyze_params_t& params) const {
+            if (!indexes_->empty())
+                return;
+
+            if (range.is_non_negative) {
+                if (range.increment_of == variable_)
+                    params.ranges.keep_non_negative(variable_);
+                else
+                    params.ranges.add_non_negative(variable_);
+            }
+            params.ranges.add_sizes(variable_, range.sizes);
+        }
+
+        range_value_t range(analyze_params_t& params) const override {
+            range_value_t result;
+            if (!variable_ || !indexes_->empty())
+                return result;
+
+            result.is_non_negative = params.ranges.is_non_negative(variable_);
+            result.increment_of    = variable_;
+            result.bound           = range_bound_t{variable_};
+            result.sizes           = params.ranges.sizes(variable_);
+            return result;
+        }
+
         node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
             node_variable_t* var_node = nullptr;
             if (variable_) {
@@ -50,8 +142,39 @@ namespace paracl {
             return buf->add_node<node_lvalue_t>(node_loc_t::loc(), var_node, indexes_->copy(params, parent));
         }
 
+        void compile(compile_params_t& params) const override {
+            assert(variable_);
+            indexes_->compile(params);
+            int slot = variable_->get_slot(params);
+            if (indexes_->empty())
+                params.emit(opcode_e::LOAD, this, slot);
+            else
+                params.emit(opcode_e::LOAD_INDEXED, indexes_, slot, indexes_->size(), indexes_->in_bounds());
+        }
+
+        void compile_set(compile_params_t& params) const {
+            assert(variable_);
+            indexes_->compile(params);
+            int slot = variable_->get_slot(params);
+            if (indexes_->empty())
+                params.emit(opcode_e::STORE, this, slot);
+            else
+                params.emit(opcode_e::STORE_INDEXED, indexes_, slot, indexes_->size(), indexes_->in_bounds());
+        }
+
+        // value of variable itself and depth of accessed element in it
+        std::pair<analyze_t, int> analyze_root() const {
+            assert(variable_);
+            return {variable_->analyze_value(), static_cast<int>(indexes_->size())};
+        }
+
         std::string_view get_name() const { assert(variable_); return variable_->get_name(); }
 
+        bool can_pause() const override { return indexes_->can_pause(); }
+
         void set_predict(bool value) override { if (variable_) variable_->set_predict(value); }
+
+        static_assert(releases_nothing_v<node_expression_t, decltype(variable_), decltype(indexes_),
+                                         decltype(access_)>);
     };
 }
\ No newline at end of file
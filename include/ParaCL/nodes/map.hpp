@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ParaCL/hash_table.hpp"
+#include "ParaCL/nodes/array.hpp"
+#include "ParaCL/nodes/simple_types.hpp"
+
+namespace paracl {
+    // map() is hash table from integer keys to integer values, key without value gives 0.
+    // maps evaluated at execution live in heap of run
+    class node_map_t final : public node_type_t,
+                             public heap_node_t {
+        hash_table_t<execute_t> e_values_;
+
+        analyze_t a_value_; // values are known only at execution
+
+    private:
+        static int key(std::span<const execute_t> indexes, const node_indexes_t* source, execute_params_t& params) {
+            const execute_t& key = indexes.front();
+            if (key.type != node_type_e::INTEGER)
+                throw error_execute_t{source->get_index_loc(0), params.program_str,
+                                      "wrong type: " + type2str(key.type)};
+            return key.number;
+        }
+
+        // values are integers, so map refers to nothing
+        void trace(value_heap_t& heap) override {}
+
+    public:
+        node_map_t(const location_t& loc, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : node_type_t(loc), e_values_(resource) {}
+
+        // every evaluation creates new map as in vm
+        execute_t execute(execute_params_t& params) override {
+            return {node_type_e::MAP, params.heap.add_node<node_map_t>(node_loc_t::loc(), params.resource)};
+        }
+
+        analyze_t analyze(analyze_params_t& params) override {
+            return {node_type_e::MAP, this};
+        }
+
+        // the first index is key, values are integers, so other indexes are ignored
+        // as after integer element of array
+        execute_t load(std::span<const execute_t> indexes, const node_indexes_t* source,
+                       execute_params_t& params) {
+            if (execute_t* value = e_values_.find(key(indexes, source, params)))
+                return *value;
+            return make_number(0);
+        }
+
+        void store(std::span<const execute_t> indexes, const node_indexes_t* source,
+                   const execute_t& value, execute_params_t& params) {
+            const int old_size = size();
+            e_values_[key(indexes, source, params)] = value;
+            params.heap.add_values(size() - old_size);
+        }
+
+        analyze_t& shift(std::span<const analyze_t> indexes, analyze_params_t& params) {
+            if (indexes.size() > 1)
+                throw error_analyze_t{indexes[1].value->loc(), params.program_str,
+                                      "indexing in depth has gone beyond boundary of map"};
+
+            a_value_ = make_number(0, params, indexes.front().value->loc(), false);
+            return a_value_;
+        }
+
+        void print(execute_params_t& params) override {
+            std::ostream& os = *(params.os);
+            os << '{';
+            bool is_first = true;
+            for (const auto& [key, value] : e_values_.sorted()) {
+                if (!is_first)
+                    os << ", ";
+                is_first = false;
+                os << key << ": ";
+                print_value(value, params);
+            }
+            os << '}';
+        }
+
+        int size() const noexcept { return e_values_.size(); }
+
+        heap_node_t* heap_node() noexcept override { return this; }
+
+        size_t count_values() const noexcept override { return size(); }
+
+        int level() const override { return 0; }
+
+        bool can_pause() const override { return false; }
+
+        node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
+            return params.buf->add_node<node_map_t>(node_loc_t::loc());
+        }
+
+        void compile(compile_params_t& params) const override {
+            params.emit(opcode_e::NEW_MAP, this);
+        }
+    };
+}
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "ParaCL/nodes/common.hpp"
 
 namespace paracl {
+    class node_print_t;
+    template <> inline constexpr bool is_arena_only_v<node_print_t> = true;
+
     class node_print_t final : public node_expression_t {
         node_expression_t* argument_;
 
@@ -11,15 +14,13 @@ namespace paracl {
         : node_expression_t(loc), argument_(argument) { assert(argument_); }
 
         execute_t execute(execute_params_t& params) override {
-            if (auto value = params.get_evaluated(this))
-                return *value;
-
-            execute_t result = argument_->execute(params);
-            if (params.is_executed()) {
-                result.value->print(params);
-                return params.add_value(this, result);
-            }
-            return {};
+            execute_t result = params.evaluate(argument_);
+            if (!params.is_executed())
+                return {};
+
+            print_value(result, params);
+            *(params.os) << '\n';
+            return result;
         }
 
         analyze_t analyze(analyze_params_t& params) override {
@@ -30,6 +31,15 @@ namespace paracl {
             return params.buf->add_node<node_print_t>(node_loc_t::loc(), argument_->copy(params, parent));
         }
 
+        void compile(compile_params_t& params) const override {
+            argument_->compile(params);
+            params.emit(opcode_e::PRINT, this);
+        }
+
+        bool can_pause() const override { return argument_->is_pausable(); }
+
         void set_predict(bool value) override { argument_->set_predict(value); }
+
+        static_assert(releases_nothing_v<node_expression_t, decltype(argument_)>);
     };
 }
\ No newline at end of file
@@ -48,11 +48,17 @@ namespace paracl {
         node_expression_t* return_expr_ = nullptr;
 
     public:
-        node_return_t(const location_t& loc, node_expression_t* return_expr)
-        : node_interpretable_t(loc), return_expr_(return_expr) { assert(return_expr_); }
+        node_return_t(const location_t& loc) : node_interpretable_t(loc) {}
+
+        void bind_expr(node_expression_t* return_expr) {
+            return_expr_ = return_expr;
+            assert(return_expr_);
+            set_loc(return_expr_->loc());
+        }
 
         void execute(execute_params_t& params) override {
-            execute_t result = return_expr_->execute(params);
+            assert(return_expr_);
+            execute_t result = params.evaluate_statement(return_expr_);
             if (params.is_executed())
                 params.add_return(result);
         }
@@ -70,13 +76,20 @@ namespace paracl {
         std::vector<node_statement_t*> statements_;
         node_expression_t* return_expr_ = nullptr;
 
+        // built once, so entering scope doesn't allocate
+        node_memory_cleaner_t memory_cleaner_;
+        node_return_t         return_node_;
+
     protected:
         template <typename FuncT, typename ParamsT>
         void process_statements(FuncT&& func, ParamsT& params) const {
             for (auto statement : statements_) {
                 std::invoke(func, statement, params);
-                if (params.analyze_state != analyze_state_e::PROCESS)
+                // rest of statements is not analyzed, so nothing is known about their assignments
+                if (params.analyze_state != analyze_state_e::PROCESS) {
+                    params.ranges.forget();
                     return;
+                }
             }
         }
 
@@ -103,6 +116,10 @@ namespace paracl {
             return scope;
         }
 
+        void compile_statements(compile_params_t& params) const {
+            through_statements([&params](auto statement) { statement->compile(params); });
+        }
+
         void set_predict_impl(bool value) {
             through_statements([value](auto statement) { statement->set_predict(value); });
             if (return_expr_)
@@ -117,16 +134,20 @@ namespace paracl {
             return result;
         }
 
-        node_memory_cleaner_t* make_memory_cleaner(const location_t& loc, copy_params_t& params) {
-            return params.buf->add_node<node_memory_cleaner_t>(loc, this);
+        void bind_return(node_expression_t* node) {
+            return_expr_ = node;
+            return_node_.bind_expr(return_expr_);
         }
 
-        node_return_t* make_return_node(copy_params_t& params) {
-            return params.buf->add_node<node_return_t>(return_expr_->loc(), return_expr_);
+        void mark_tail_calls_impl() {
+            through_statements([](auto statement) { statement->mark_tail_calls(); });
+            if (return_expr_)
+                return_expr_->mark_tail_calls();
         }
 
     public:
-        scope_base_t(scope_base_t* parent) : parent_(parent) {} 
+        scope_base_t(const location_t& loc, scope_base_t* parent)
+        : parent_(parent), memory_cleaner_(loc, this), return_node_(loc) {}
 
         void push_statement(node_statement_t* node) {
             assert(node);
@@ -140,7 +161,7 @@ namespace paracl {
             if (return_expr_)
                 return;
 
-            return_expr_ = node;
+            bind_return(node);
         }
 
         void finish_return(buffer_t* buf) {
@@ -149,9 +170,10 @@ namespace paracl {
 
             if (!statements_.empty()) {
                 copy_params_t params{buf};
-                return_expr_ = statements_.back()->to_expression(params, this);
-                if (return_expr_)
+                if (node_expression_t* return_expr = statements_.back()->to_expression(params, this)) {
+                    bind_return(return_expr);
                     statements_.pop_back();
+                }
             }
         }
 
@@ -173,22 +195,26 @@ namespace paracl {
                                       public scope_base_t {
     public:
         node_scope_return_t(const location_t& loc, scope_base_t* parent)
-        : node_expression_t(loc), scope_base_t(parent) {}
+        : node_expression_t(loc), scope_base_t(loc, parent) {}
 
         execute_t execute(execute_params_t& params) override {
             if (params.is_visited(this)) {
                 execute_t result = params.stack.pop_value();
-                if (!result.value)
+                if (result.is_empty)
                     throw error_execute_t{node_loc_t::loc(), params.program_str, "missing return value"};
                 return result;
             }
             params.visit(this);
+            enter(params);
+            return {};
+        }
 
-            params.insert_statement(make_memory_cleaner(node_loc_t::loc(), params.copy_params));
+        // statements of scope wait for return above the memory cleaner
+        void enter(execute_params_t& params) {
+            params.insert_statement(&memory_cleaner_);
             params.add_return_receiver();
-            params.insert_statement(make_return_node(params.copy_params));
+            params.insert_statement(&return_node_);
             params.insert_statements(statements_.rbegin(), statements_.rend());
-            return {};
         }
 
         analyze_t analyze(analyze_params_t& params) override {
@@ -221,6 +247,20 @@ namespace paracl {
             return copy_impl<node_scope_return_t>(scope_r, params);
         }
 
+        void compile(compile_params_t& params) const override {
+            params.open_receiver(this);
+            compile_statements(params);
+            if (return_expr_)
+                return_expr_->compile(params);
+            else
+                params.emit(opcode_e::MISSING_RETURN, this);
+            params.close_receiver();
+        }
+
+        bool can_pause() const override { return true; }
+
+        void mark_tail_calls() override { mark_tail_calls_impl(); }
+
         template <typename IterT>
         node_scope_return_t* copy_with_args(copy_params_t& params, scope_base_t* parent,
                                           IterT args_begin, IterT args_end) const {
@@ -240,16 +280,16 @@ namespace paracl {
                                public scope_base_t {
     public:
         node_scope_t(const location_t& loc, scope_base_t* parent)
-        : node_strong_statement_t(loc), scope_base_t(parent) {}
+        : node_strong_statement_t(loc), scope_base_t(loc, parent) {}
 
         void execute(execute_params_t& params) override {
             if (params.is_visited(this))
                 return;
 
             params.visit(this);
-            params.insert_statement(make_memory_cleaner(node_loc_t::loc(), params.copy_params));
+            params.insert_statement(&memory_cleaner_);
             if (return_expr_)
-                params.insert_statement(make_return_node(params.copy_params));
+                params.insert_statement(&return_node_);
             params.insert_statements(statements_.rbegin(), statements_.rend());
         }
 
@@ -269,6 +309,16 @@ namespace paracl {
             return copy_impl<node_scope_t>(scope, params);
         }
 
+        void compile(compile_params_t& params) const override {
+            compile_statements(params);
+            if (return_expr_) {
+                return_expr_->compile(params);
+                params.emit_return(this);
+            }
+        }
+
+        void mark_tail_calls() override { mark_tail_calls_impl(); }
+
         node_scope_return_t* to_scope_r(copy_params_t& params, scope_base_t* parent) const {
             node_scope_return_t* scope_r = params.buf->add_node<node_scope_return_t>(node_loc_t::loc(), parent);
             simple_copy_impl<node_scope_return_t>(scope_r, params);
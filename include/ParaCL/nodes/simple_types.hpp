@@ -3,6 +3,9 @@
 #include "ParaCL/nodes/common.hpp"
 
 namespace paracl {
+    class node_number_t;
+    template <> inline constexpr bool is_arena_only_v<node_number_t> = true;
+
     class node_number_t final : public node_simple_type_t {
         int number_;
 
@@ -10,33 +13,51 @@ namespace paracl {
         node_number_t(const location_t& loc, int number) : node_simple_type_t(loc), number_(number) {}
 
         execute_t execute(execute_params_t& params) override {
-            return {node_type_e::INTEGER, this};
+            return execute_t{number_};
         }
 
         analyze_t analyze(analyze_params_t& params) override {
             return {node_type_e::INTEGER, this};
         }
 
-        void print(execute_params_t& params) override { *(params.os) << number_ << '\n'; }
+        void print(execute_params_t& params) override { *(params.os) << number_; }
 
         int get_value() const noexcept { return number_; }
 
+        std::optional<int> constant() const override { return number_; }
+
+        range_value_t range(analyze_params_t& params) const override {
+            range_value_t result;
+            result.is_non_negative = number_ >= 0;
+            result.bound = range_bound_t{nullptr, number_};
+            return result;
+        }
+
         node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
             return params.buf->add_node<node_number_t>(node_loc_t::loc(), number_);
         }
+
+        void compile(compile_params_t& params) const override {
+            params.emit(opcode_e::PUSH_INT, this, number_);
+        }
+
+        static_assert(releases_nothing_v<node_simple_type_t, decltype(number_)>);
     };
 
     /* ----------------------------------------------------- */
 
+    class node_undef_t;
+    template <> inline constexpr bool is_arena_only_v<node_undef_t> = true;
+
     class node_undef_t final : public node_simple_type_t {
     public:
         node_undef_t(const location_t& loc) : node_simple_type_t(loc) {}
 
         execute_t execute(execute_params_t& params) override {
-            return {node_type_e::UNDEF, this};
+            return {node_type_e::UNDEF};
         }
 
-        void print(execute_params_t& params) override { *(params.os) << "undef\n"; }
+        void print(execute_params_t& params) override { *(params.os) << "undef"; }
 
         analyze_t analyze(analyze_params_t& params) override {
             return {node_type_e::UNDEF, this};
@@ -45,50 +66,60 @@ namespace paracl {
         node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
             return params.buf->add_node<node_undef_t>(node_loc_t::loc());
         }
+
+        void compile(compile_params_t& params) const override {
+            params.emit(opcode_e::PUSH_UNDEF, this);
+        }
+
+        static_assert(releases_nothing_v<node_simple_type_t>);
     };
 
     /* ----------------------------------------------------- */
 
+    class node_input_t;
+    template <> inline constexpr bool is_arena_only_v<node_input_t> = true;
+
     class node_input_t final : public node_simple_type_t {
     public:
         node_input_t(const location_t& loc) : node_simple_type_t(loc) {}
 
         execute_t execute(execute_params_t& params) override {
-            if (auto value = params.get_evaluated(this))
-                return *value;
-
             int value;
             *(params.is) >> value;
             if (!params.is->good())
                 throw error_execute_t{node_loc_t::loc(), params.program_str, "invalid input: need integer"};
-            
-            return params.add_value(
-                this,
-                node_type_e::INTEGER,
-                params.buf()->add_node<node_number_t>(node_loc_t::loc(), value)
-            );
+
+            return execute_t{value};
         }
 
         analyze_t analyze(analyze_params_t& params) override {
             return {node_type_e::INPUT, params.buf()->add_node<node_input_t>(node_loc_t::loc())};
         }
 
-        void print(execute_params_t& params) override { *(params.os) << "?\n"; }
+        void print(execute_params_t& params) override { *(params.os) << "?"; }
 
         node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
             return params.buf->add_node<node_input_t>(node_loc_t::loc());
         }
+
+        void compile(compile_params_t& params) const override {
+            params.emit(opcode_e::INPUT, this);
+        }
+
+        static_assert(releases_nothing_v<node_simple_type_t>);
     };
 
     /* ----------------------------------------------------- */
 
-    template <existed_params ParamsT>
-    inline execute_t make_undef(ParamsT& params, const location_t& loc) {
-        return {node_type_e::UNDEF, params.buf()->template add_node<node_undef_t>(loc)};
+    inline execute_t make_undef() {
+        return {node_type_e::UNDEF};
+    }
+
+    inline execute_t make_number(int value) {
+        return execute_t{value};
     }
 
-    template <existed_params ParamsT>
-    inline execute_t make_number(int value, ParamsT& params, const location_t& loc) {
-        return {node_type_e::INTEGER, params.buf()->template add_node<node_number_t>(loc, value)};
+    inline analyze_t make_number(int value, analyze_params_t& params, const location_t& loc, bool is_constexpr) {
+        return {node_type_e::INTEGER, params.buf()->add_node<node_number_t>(loc, value), is_constexpr};
     }
 }
\ No newline at end of file
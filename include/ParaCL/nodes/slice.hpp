@@ -0,0 +1,101 @@
+#pragma once
+
+#include "ParaCL/nodes/array.hpp"
+
+namespace paracl {
+    // slice(array, begin, end) is view over elements [begin, end) of array without copy of them
+    class node_slice_t;
+    template <> inline constexpr bool is_arena_only_v<node_slice_t> = true;
+
+    class node_slice_t final : public node_expression_t {
+        node_expression_t* array_;
+        node_expression_t* begin_;
+        node_expression_t* end_;
+        node_indexes_t*    indexes_;
+
+    public:
+        node_slice_t(const location_t& loc, node_expression_t* array, node_expression_t* begin,
+                     node_expression_t* end, node_indexes_t* indexes)
+        : node_expression_t(loc), array_(array), begin_(begin), end_(end), indexes_(indexes) {
+            assert(array_);
+            assert(begin_);
+            assert(end_);
+            assert(indexes_);
+        }
+
+        execute_t execute(execute_params_t& params) override {
+            execute_t array = params.evaluate(array_);
+            if (!params.is_executed())
+                return {};
+            execute_t begin = params.evaluate(begin_);
+            if (!params.is_executed())
+                return {};
+            execute_t end = params.evaluate(end_);
+            if (!params.is_executed())
+                return {};
+
+            expect_types_eq(array.type, node_type_e::ARRAY,   node_loc_t::loc(), params);
+            expect_types_eq(begin.type, node_type_e::INTEGER, node_loc_t::loc(), params);
+            expect_types_eq(end.type,   node_type_e::INTEGER, node_loc_t::loc(), params);
+
+            node_array_t* view = static_cast<node_array_t*>(array.value)->slice(begin.number, end.number,
+                                                                                  node_loc_t::loc(), params);
+            if (indexes_->empty())
+                return {node_type_e::ARRAY, view};
+
+            // few indexes without calls are evaluated without vector as in lvalue
+            if (!indexes_->can_pause() && indexes_->size() <= node_indexes_t::max_fixed_depth) {
+                node_indexes_t::fixed_indexes_t buffer;
+                return view->load(indexes_->execute(buffer, params), indexes_, params);
+            }
+
+            execute_values_t indexes = indexes_->execute(params);
+            if (!params.is_executed())
+                return {};
+            return view->load(indexes, indexes_, params);
+        }
+
+        analyze_t analyze(analyze_params_t& params) override {
+            analyze_t array = array_->analyze(params);
+            expect_types_eq(array.type, node_type_e::ARRAY, array_->loc(), params);
+            for (node_expression_t* bound : {begin_, end_}) {
+                analyze_t result = bound->analyze(params);
+                expect_types_ne(result.type, node_type_e::ARRAY, bound->loc(), params);
+                expect_types_ne(result.type, node_type_e::MAP,   bound->loc(), params);
+                expect_types_ne(result.type, node_type_e::UNDEF, bound->loc(), params);
+            }
+
+            analyze_t elem = static_cast<node_array_t*>(array.value)->analyze_slice(node_loc_t::loc(), params);
+            return analyze_unknown_array(node_loc_t::loc(), elem, indexes_, params);
+        }
+
+        node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
+            return params.buf->add_node<node_slice_t>(node_loc_t::loc(), array_->copy(params, parent),
+                                                      begin_->copy(params, parent), end_->copy(params, parent),
+                                                      indexes_->copy(params, parent));
+        }
+
+        void compile(compile_params_t& params) const override {
+            array_->compile(params);
+            begin_->compile(params);
+            end_->compile(params);
+            params.emit(opcode_e::SLICE, this);
+            indexes_->compile(params);
+            if (!indexes_->empty())
+                params.emit(opcode_e::INDEX, indexes_, 0, indexes_->size());
+        }
+
+        bool can_pause() const override {
+            return array_->is_pausable() || begin_->is_pausable() || end_->is_pausable() || indexes_->can_pause();
+        }
+
+        void set_predict(bool value) override {
+            array_->set_predict(value);
+            begin_->set_predict(value);
+            end_->set_predict(value);
+        }
+
+        static_assert(releases_nothing_v<node_expression_t, decltype(array_), decltype(begin_), decltype(end_),
+                                         decltype(indexes_)>);
+    };
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "ParaCL/nodes/common.hpp"
+#include "ParaCL/nodes/array.hpp"
+#include "ParaCL/nodes/simple_types.hpp"
 
 namespace paracl {
     enum class unary_operators_e {
@@ -8,15 +9,26 @@ namespace paracl {
         SUB,
         NOT
     };
+
+    inline opcode_e to_opcode(unary_operators_e type) {
+        switch (type) {
+            case unary_operators_e::ADD: return opcode_e::POS;
+            case unary_operators_e::SUB: return opcode_e::NEG;
+            case unary_operators_e::NOT: return opcode_e::NOT;
+            default: throw error_t{str_red("failed to_opcode(): unknown unary operator")};
+        }
+    }
+
+    class node_un_op_t;
+    template <> inline constexpr bool is_arena_only_v<node_un_op_t> = true;
+
     class node_un_op_t final : public node_expression_t {
         unary_operators_e  type_;
         node_expression_t* node_;
 
     private:
         template <typename ParamsT>
-        int evaluate(node_number_t* result, ParamsT& params) const {
-            assert(result);
-            int value = result->get_value();
+        int evaluate(int value, ParamsT& params) const {
             switch (type_) {
                 case unary_operators_e::ADD: return  value;
                 case unary_operators_e::SUB: return -value;
@@ -26,41 +38,76 @@ namespace paracl {
             }
         }
 
+        // kernel takes 0 as left operand
+        simd_op_e to_simd() const noexcept {
+            switch (type_) {
+                case unary_operators_e::SUB: return simd_op_e::SUB;
+                case unary_operators_e::NOT: return simd_op_e::EQ;
+                default: return simd_op_e::ADD;
+            }
+        }
+
     public:
         node_un_op_t(const location_t& loc, unary_operators_e type, node_expression_t* node)
         : node_expression_t(loc), type_(type), node_(node) { assert(node_); }
 
         execute_t execute(execute_params_t& params) override {
-            execute_t res_exec = node_->execute(params);
+            execute_t res_exec = params.evaluate(node_);
             if (!params.is_executed())
                 return {};
 
             if (res_exec.type == node_type_e::UNDEF)
-                return {node_type_e::UNDEF, params.buf()->add_node<node_undef_t>(node_loc_t::loc())};
+                return make_undef();
 
-            int result = evaluate(static_cast<node_number_t*>(res_exec.value), params);
-            return {node_type_e::INTEGER, params.buf()->add_node<node_number_t>(node_loc_t::loc(), result)};
+            if (res_exec.type == node_type_e::ARRAY)
+                return elementwise(res_exec, to_simd(), [&](int value) { return evaluate(value, params); },
+                                   node_loc_t::loc(), params);
+
+            expect_types_eq(res_exec.type, node_type_e::INTEGER, node_loc_t::loc(), params);
+            return make_number(evaluate(res_exec.number, params));
+        }
+
+        // literal with sign is constant too
+        std::optional<int> constant() const override {
+            std::optional<int> value = node_->constant();
+            if (!value || type_ == unary_operators_e::NOT)
+                return std::nullopt;
+            if (type_ == unary_operators_e::SUB && *value == std::numeric_limits<int>::min())
+                return std::nullopt;
+            return type_ == unary_operators_e::SUB ? -*value : *value;
         }
 
         analyze_t analyze(analyze_params_t& params) override {
             analyze_t res_exec = node_->analyze(params);
+            expect_types_ne(res_exec.type, node_type_e::MAP, node_loc_t::loc(), params);
 
             if (res_exec.type == node_type_e::UNDEF ||
                 res_exec.type == node_type_e::INPUT)
                 return res_exec;
 
-            expect_types_ne(res_exec.type, node_type_e::ARRAY, node_loc_t::loc(), params);
+            if (res_exec.type == node_type_e::ARRAY) {
+                auto* array = static_cast<node_array_t*>(res_exec.value);
+                return analyze_unknown_array(node_loc_t::loc(), array->analyze_element(node_loc_t::loc(), params),
+                                             nullptr, params);
+            }
 
-            int result = evaluate(static_cast<node_number_t*>(res_exec.value), params);
-            analyze_t a_result{node_type_e::INTEGER, params.buf()->add_node<node_number_t>(node_loc_t::loc(), result)};
-            a_result.is_constexpr = res_exec.is_constexpr;
-            return a_result;
+            int result = evaluate(static_cast<node_number_t*>(res_exec.value)->get_value(), params);
+            return make_number(result, params, node_loc_t::loc(), res_exec.is_constexpr);
         }
 
         node_expression_t* copy(copy_params_t& params, scope_base_t* parent) const override {
             return params.buf->add_node<node_un_op_t>(node_loc_t::loc(), type_, node_->copy(params, parent));
         }
 
+        void compile(compile_params_t& params) const override {
+            node_->compile(params);
+            params.emit(to_opcode(type_), this);
+        }
+
+        bool can_pause() const override { return node_->is_pausable(); }
+
         void set_predict(bool value) override { node_->set_predict(value); }
+
+        static_assert(releases_nothing_v<node_expression_t, decltype(type_), decltype(node_)>);
     };
 }
\ No newline at end of file
@@ -1,16 +1,35 @@
 #pragma once
 
-#include "ParaCL/nodes/array.hpp"
+#include "ParaCL/nodes/map.hpp"
 
 namespace paracl {
+    // variable holds its value as root of heap of run, values in frames are reached through them
     class settable_value_t : public node_t,
                              public node_loc_t,
-                             public node_settable_t {
-        bool is_setted = false;
-        execute_t e_value_;
+                             public node_settable_t,
+                             public heap_node_t {
+        execute_t e_value_{node_type_e::UNDEF};
         analyze_t a_value_;
 
+        const frame_info_t* frame_ = nullptr; // function, which body declares variable
+        int slot_ = -1;
+        bool is_setted = false;
+
     private:
+        // outside of calls variable of function keeps its own value
+        execute_t& value(execute_params_t& params) {
+            if (frame_)
+                if (execute_t* value = params.frames.find(*frame_, slot_))
+                    return *value;
+            return e_value_;
+        }
+
+        void assign(const execute_t& new_value, execute_params_t& params) {
+            if (new_value.is_boxed())
+                params.heap.add_root(this);
+            value(params) = new_value;
+        }
+
         static void check_types_in_assign(general_type_e l_type, general_type_e r_type,
                                           const location_t& loc_set, analyze_params_t& params) {
             if (l_type == r_type)
@@ -41,34 +60,63 @@ namespace paracl {
             }
         }
 
-        execute_t& shift(const std::vector<execute_t>& indexes, execute_params_t& params) {
-            if (indexes.size() == 0)
-                return e_value_;
+        execute_t load(std::span<const execute_t> indexes, const node_indexes_t* ext_indexes,
+                       execute_params_t& params) {
+            execute_t& e_value = value(params);
+            if (indexes.size() == 0 || !params.is_executed())
+                return e_value;
+
+            if (e_value.type == node_type_e::MAP)
+                return static_cast<node_map_t*>(e_value.value)->load(indexes, ext_indexes, params);
+            expect_types_eq(e_value.type, node_type_e::ARRAY, node_loc_t::loc(), params);
+            node_array_t* array = static_cast<node_array_t*>(e_value.value);
+            return array->load(indexes, ext_indexes, params);
+        }
 
-            node_array_t* array = static_cast<node_array_t*>(e_value_.value);
-            return array->shift(indexes, params);
+        void store(std::span<const execute_t> indexes, const node_indexes_t* ext_indexes,
+                   const execute_t& new_value, execute_params_t& params) {
+            if (indexes.size() == 0)
+                return assign(new_value, params);
+
+            execute_t& e_value = value(params);
+            if (e_value.type == node_type_e::MAP)
+                return static_cast<node_map_t*>(e_value.value)->store(indexes, ext_indexes, new_value, params);
+            expect_types_eq(e_value.type, node_type_e::ARRAY, node_loc_t::loc(), params);
+            node_array_t* array = static_cast<node_array_t*>(e_value.value);
+            array->store(indexes, ext_indexes, new_value, params);
         }
 
-        analyze_t& shift_analyze(const std::vector<analyze_t>& indexes, analyze_params_t& params) {
+        analyze_t& shift_analyze(std::span<const analyze_t> indexes, analyze_params_t& params) {
             if (indexes.size() == 0)
                 return a_value_;
             
+            if (a_value_.type == node_type_e::MAP)
+                return static_cast<node_map_t*>(a_value_.value)->shift(indexes, params);
             expect_types_eq(a_value_.type, node_type_e::ARRAY, node_loc_t::loc(), params);
             node_array_t* array = static_cast<node_array_t*>(a_value_.value);
             return array->shift(indexes, params);
         }
 
+    protected:
+        void trace(value_heap_t& heap) override { heap.reach(e_value_); }
+
     public:
         settable_value_t(const location_t& loc) : node_loc_t(loc) {}
 
         execute_t execute(execute_params_t& params) override {
-            return e_value_;
+            return value(params);
         }
 
         execute_t execute(node_indexes_t* indexes, execute_params_t& params) {
             assert(indexes);
-            execute_t real_value = shift(indexes->execute(params), params);
-            return real_value;
+            execute_values_t values = indexes->execute(params);
+            return load(values, indexes, params);
+        }
+
+        // indexes are evaluated by caller
+        execute_t execute(std::span<const execute_t> values, const node_indexes_t* indexes,
+                          execute_params_t& params) {
+            return load(values, indexes, params);
         }
 
         analyze_t analyze(node_indexes_t* ext_indexes, analyze_params_t& params) {
@@ -82,13 +130,15 @@ namespace paracl {
 
         execute_t set_value(execute_t new_value, execute_params_t& params) override {
             is_setted = true;
-            return e_value_ = new_value;
+            assign(new_value, params);
+            return new_value;
         }
 
         analyze_t set_value_analyze(analyze_t new_value, analyze_params_t& params,
                                     const location_t& loc_set) {
             if (is_setted)
                 expect_types_assignable(a_value_, new_value, loc_set, params);
+            params.ranges.assign(this, 0, true);
 
             is_setted = true;
             a_value_.type  = new_value.type;
@@ -99,12 +149,18 @@ namespace paracl {
 
         execute_t set_value(node_indexes_t* indexes, execute_t new_value, execute_params_t& params) {
             assert(indexes);
-            execute_t& real_value = shift(indexes->execute(params), params);
+            execute_values_t values = indexes->execute(params);
+            return set_value(values, indexes, new_value, params);
+        }
+
+        execute_t set_value(std::span<const execute_t> values, const node_indexes_t* indexes,
+                            execute_t new_value, execute_params_t& params) {
             if (!params.is_executed())
                 return {};
 
+            store(values, indexes, new_value, params);
             is_setted = true;
-            return real_value = new_value;
+            return new_value;
         }
 
         analyze_t set_value_analyze(node_indexes_t* ext_indexes, analyze_t new_value,
@@ -119,6 +175,8 @@ namespace paracl {
 
             if (is_setted)
                 expect_types_assignable(shift_result, new_value, loc_set, params);
+            params.ranges.assign(this, indexes.size(),
+                                 to_general_type(new_value.type) == general_type_e::INTEGER);
 
             is_setted = true;
             shift_result.type  = new_value.type;
@@ -129,6 +187,20 @@ namespace paracl {
 
         void set_predict(bool value) { a_value_.is_constexpr = value; }
 
+        const analyze_t& analyze_value() const noexcept { return a_value_; }
+
+        void bind_slot(const frame_info_t* frame, int slot) {
+            assert(frame);
+            frame_ = frame;
+            slot_  = slot;
+        }
+
+        int get_slot(compile_params_t& params) const {
+            if (frame_)
+                return params.get_frame(*frame_) + slot_;
+            return params.get_slot(this);
+        }
+
         virtual ~settable_value_t() = default;
     };
 
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PARACL_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace paracl {
+    // operators, which kernels apply to lanes of integers. arithmetic wraps as in two's complement,
+    // comparisons give 0 or 1
+    enum class simd_op_e {
+        ADD,
+        SUB,
+        MUL,
+        EQ,
+        NE,
+        LT,
+        LE,
+        GT,
+        GE
+    };
+
+    enum class simd_level_e {
+        SCALAR,
+        SSE41,
+        AVX2
+    };
+
+    // operand of kernel is integers one after another or one integer for every lane
+    struct simd_operand_t final {
+        const int* data  = nullptr;
+        int        value = 0;
+
+        int operator[](size_t i) const noexcept { return data ? data[i] : value; }
+    };
+
+    /* ----------------------------------------------------- */
+
+    template <simd_op_e OpV>
+    int simd_scalar(int lhs, int rhs) noexcept {
+        using u32 = uint32_t;
+        if constexpr (OpV == simd_op_e::ADD) return static_cast<int>(u32(lhs) + u32(rhs));
+        if constexpr (OpV == simd_op_e::SUB) return static_cast<int>(u32(lhs) - u32(rhs));
+        if constexpr (OpV == simd_op_e::MUL) return static_cast<int>(u32(lhs) * u32(rhs));
+        if constexpr (OpV == simd_op_e::EQ)  return lhs == rhs;
+        if constexpr (OpV == simd_op_e::NE)  return lhs != rhs;
+        if constexpr (OpV == simd_op_e::LT)  return lhs <  rhs;
+        if constexpr (OpV == simd_op_e::LE)  return lhs <= rhs;
+        if constexpr (OpV == simd_op_e::GT)  return lhs >  rhs;
+        if constexpr (OpV == simd_op_e::GE)  return lhs >= rhs;
+    }
+
+    template <simd_op_e OpV>
+    void simd_lanes_scalar(simd_operand_t lhs, simd_operand_t rhs, std::span<int> out, size_t begin) noexcept {
+        for (size_t i = begin; i < out.size(); ++i)
+            out[i] = simd_scalar<OpV>(lhs[i], rhs[i]);
+    }
+
+#ifdef PARACL_SIMD_X86
+    // mask of comparison has all bits of lane set, it is turned into 1
+    template <simd_op_e OpV>
+    __attribute__((target("sse4.1")))
+    void simd_lanes_sse41(simd_operand_t lhs, simd_operand_t rhs, std::span<int> out) noexcept {
+        const __m128i one     = _mm_set1_epi32(1);
+        const __m128i l_value = _mm_set1_epi32(lhs.value);
+        const __m128i r_value = _mm_set1_epi32(rhs.value);
+
+        size_t i = 0;
+        for (; i + 4 <= out.size(); i += 4) {
+            const __m128i l = lhs.data ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs.data + i)) : l_value;
+            const __m128i r = rhs.data ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs.data + i)) : r_value;
+            __m128i result;
+            if constexpr (OpV == simd_op_e::ADD) result = _mm_add_epi32(l, r);
+            if constexpr (OpV == simd_op_e::SUB) result = _mm_sub_epi32(l, r);
+            if constexpr (OpV == simd_op_e::MUL) result = _mm_mullo_epi32(l, r);
+            if constexpr (OpV == simd_op_e::EQ)  result = _mm_and_si128   (_mm_cmpeq_epi32(l, r), one);
+            if constexpr (OpV == simd_op_e::NE)  result = _mm_andnot_si128(_mm_cmpeq_epi32(l, r), one);
+            if constexpr (OpV == simd_op_e::LT)  result = _mm_and_si128   (_mm_cmpgt_epi32(r, l), one);
+            if constexpr (OpV == simd_op_e::LE)  result = _mm_andnot_si128(_mm_cmpgt_epi32(l, r), one);
+            if constexpr (OpV == simd_op_e::GT)  result = _mm_and_si128   (_mm_cmpgt_epi32(l, r), one);
+            if constexpr (OpV == simd_op_e::GE)  result = _mm_andnot_si128(_mm_cmpgt_epi32(r, l), one);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + i), result);
+        }
+        simd_lanes_scalar<OpV>(lhs, rhs, out, i);
+    }
+
+    template <simd_op_e OpV>
+    __attribute__((target("avx2")))
+    void simd_lanes_avx2(simd_operand_t lhs, simd_operand_t rhs, std::span<int> out) noexcept {
+        const __m256i one     = _mm256_set1_epi32(1);
+        const __m256i l_value = _mm256_set1_epi32(lhs.value);
+        const __m256i r_value = _mm256_set1_epi32(rhs.value);
+
+        size_t i = 0;
+        for (; i + 8 <= out.size(); i += 8) {
+            const __m256i l = lhs.data ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs.data + i)) : l_value;
+            const __m256i r = rhs.data ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs.data + i)) : r_value;
+            __m256i result;
+            if constexpr (OpV == simd_op_e::ADD) result = _mm256_add_epi32(l, r);
+            if constexpr (OpV == simd_op_e::SUB) result = _mm256_sub_epi32(l, r);
+            if constexpr (OpV == simd_op_e::MUL) result = _mm256_mullo_epi32(l, r);
+            if constexpr (OpV == simd_op_e::EQ)  result = _mm256_and_si256   (_mm256_cmpeq_epi32(l, r), one);
+            if constexpr (OpV == simd_op_e::NE)  result = _mm256_andnot_si256(_mm256_cmpeq_epi32(l, r), one);
+            if constexpr (OpV == simd_op_e::LT)  result = _mm256_and_si256   (_mm256_cmpgt_epi32(r, l), one);
+            if constexpr (OpV == simd_op_e::LE)  result = _mm256_andnot_si256(_mm256_cmpgt_epi32(l, r), one);
+            if constexpr (OpV == simd_op_e::GT)  result = _mm256_and_si256   (_mm256_cmpgt_epi32(l, r), one);
+            if constexpr (OpV == simd_op_e::GE)  result = _mm256_andnot_si256(_mm256_cmpgt_epi32(r, l), one);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.data() + i), result);
+        }
+        simd_lanes_scalar<OpV>(lhs, rhs, out, i);
+    }
+#endif
+
+    template <simd_op_e OpV>
+    void simd_lanes(simd_operand_t lhs, simd_operand_t rhs, std::span<int> out, simd_level_e level) noexcept {
+        switch (level) {
+#ifdef PARACL_SIMD_X86
+            case simd_level_e::AVX2:  simd_lanes_avx2 <OpV>(lhs, rhs, out); return;
+            case simd_level_e::SSE41: simd_lanes_sse41<OpV>(lhs, rhs, out); return;
+#endif
+            default: simd_lanes_scalar<OpV>(lhs, rhs, out, 0); return;
+        }
+    }
+
+    /* ----------------------------------------------------- */
+
+    // the widest kernels, which processor of run supports, they are chosen once
+    inline simd_level_e simd_level() noexcept {
+        static const simd_level_e level = [] {
+#ifdef PARACL_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return simd_level_e::AVX2;
+            if (__builtin_cpu_supports("sse4.1"))
+                return simd_level_e::SSE41;
+#endif
+            return simd_level_e::SCALAR;
+        }();
+        return level;
+    }
+
+    inline bool is_simd_supported(simd_level_e level) noexcept { return level <= simd_level(); }
+
+    // out[i] = lhs[i] op rhs[i], level must be supported by processor
+    inline void simd_apply(simd_op_e op, simd_operand_t lhs, simd_operand_t rhs, std::span<int> out,
+                           simd_level_e level = simd_level()) noexcept {
+        switch (op) {
+            case simd_op_e::ADD: simd_lanes<simd_op_e::ADD>(lhs, rhs, out, level); return;
+            case simd_op_e::SUB: simd_lanes<simd_op_e::SUB>(lhs, rhs, out, level); return;
+            case simd_op_e::MUL: simd_lanes<simd_op_e::MUL>(lhs, rhs, out, level); return;
+            case simd_op_e::EQ:  simd_lanes<simd_op_e::EQ> (lhs, rhs, out, level); return;
+            case simd_op_e::NE:  simd_lanes<simd_op_e::NE> (lhs, rhs, out, level); return;
+            case simd_op_e::LT:  simd_lanes<simd_op_e::LT> (lhs, rhs, out, level); return;
+            case simd_op_e::LE:  simd_lanes<simd_op_e::LE> (lhs, rhs, out, level); return;
+            case simd_op_e::GT:  simd_lanes<simd_op_e::GT> (lhs, rhs, out, level); return;
+            case simd_op_e::GE:  simd_lanes<simd_op_e::GE> (lhs, rhs, out, level); return;
+        }
+    }
+}
\ No newline at end of file
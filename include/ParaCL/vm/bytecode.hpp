@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace paracl {
+    class node_loc_t;
+
+    enum class opcode_e : uint8_t {
+        PUSH_INT,
+        PUSH_UNDEF,
+        PUSH_FUNCTION,
+        INPUT,
+        POP,
+
+        LOAD,
+        STORE,
+        LOAD_INDEXED,
+        STORE_INDEXED,
+        INDEX,
+
+        NEW_ARRAY,
+        NEW_REPEAT,
+        NEW_CONSTANTS,
+        ARRAY_APPEND,
+        ARRAY_APPEND_REPEAT,
+        SLICE,
+        ARRAY_PUSH,
+        ARRAY_POP,
+        ARRAY_LEN,
+        NEW_MAP,
+
+        EQ,
+        NE,
+        LE,
+        GE,
+        LT,
+        GT,
+        ADD,
+        SUB,
+        MUL,
+        DIV,
+        MOD,
+
+        OR_LEFT,
+        AND_LEFT,
+        TO_BOOL,
+
+        POS,
+        NEG,
+        NOT,
+
+        PRINT,
+
+        JUMP,
+        JUMP_IF_UNDEF,
+        JUMP_IF_FALSE,
+        JUMP_IF_TRUE,
+
+        CALL,
+        TAIL_CALL,
+        RET,
+
+        MISSING_RETURN,
+        HALT
+    };
+
+    /* ----------------------------------------------------- */
+
+    struct instruction_t final {
+        opcode_e op;
+        uint8_t  in_bounds = 0; // indexes of access, which are proven to be in bounds of array
+        int      arg   = 0;
+        int      extra = 0;
+    };
+
+    /* ----------------------------------------------------- */
+
+    struct function_info_t final {
+        std::string name;
+        int frame_begin = 0;  // first slot of frame, arguments take first slots of it
+        int count_args  = 0;
+        int count_slots = 0;
+        int entry       = -1;
+    };
+
+    /* ----------------------------------------------------- */
+
+    class bytecode_t final {
+        std::vector<instruction_t>     code_;
+        std::vector<const node_loc_t*> sources_; // node of every instruction, for error reports
+        std::vector<function_info_t>   functions_;
+        std::vector<int>               constants_; // elements of arrays created by NEW_CONSTANTS
+        int count_slots_ = 0;
+
+    public:
+        int emit(opcode_e op, const node_loc_t* source, int arg = 0, int extra = 0, uint8_t in_bounds = 0) {
+            code_.push_back({op, in_bounds, arg, extra});
+            sources_.push_back(source);
+            return code_.size() - 1;
+        }
+
+        // jumps are relative to the jump instruction, so blocks of code can be moved safely
+        void patch_jump(int jump, int target) {
+            assert(jump >= 0 && jump < static_cast<int>(code_.size()));
+            code_[jump].arg = target - jump;
+        }
+
+        void erase(int position) {
+            code_.erase(code_.begin() + position);
+            sources_.erase(sources_.begin() + position);
+        }
+
+        int add_slot() noexcept { return count_slots_++; }
+        int add_slots(int count) noexcept { int first = count_slots_; count_slots_ += count; return first; }
+        int count_slots() const noexcept { return count_slots_; }
+
+        int add_function(std::string_view name, int frame_begin, int count_args, int count_slots) {
+            functions_.push_back({std::string{name}, frame_begin, count_args, count_slots});
+            return functions_.size() - 1;
+        }
+
+        int add_constants(std::span<const int> constants) {
+            int first = constants_.size();
+            constants_.insert(constants_.end(), constants.begin(), constants.end());
+            return first;
+        }
+
+        const std::vector<int>& constants() const noexcept { return constants_; }
+
+        function_info_t& function(int index) { return functions_[index]; }
+        const function_info_t& function(int index) const { return functions_[index]; }
+        size_t count_functions() const noexcept { return functions_.size(); }
+
+        instruction_t& operator[](int position) { return code_[position]; }
+        const instruction_t& operator[](int position) const { return code_[position]; }
+        const instruction_t* data() const noexcept { return code_.data(); }
+        const node_loc_t* source(int position) const { return sources_[position]; }
+
+        int size() const noexcept { return code_.size(); }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "ParaCL/common.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+namespace paracl {
+    // runs program without shell, so names of files are passed as they are
+    inline int run_process(const std::vector<std::string>& args) {
+        std::vector<char*> argv;
+        for (const std::string& arg : args)
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        argv.push_back(nullptr);
+
+        pid_t pid;
+        int error = posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ);
+        if (error != 0)
+            throw error_t{str_red("can't run " + args[0] + ": " + std::strerror(error))};
+
+        int status;
+        while (waitpid(pid, &status, 0) == -1)
+            if (errno != EINTR)
+                throw error_t{str_red("can't wait for " + args[0] + ": " + std::strerror(errno))};
+        return status;
+    }
+
+    // binary is placed near source: its name is name of source without extension,
+    // $CXX is split by spaces, so it may contain launcher or flags
+    inline std::string compile_c(const std::string& source_file) {
+        std::filesystem::path binary = std::filesystem::path{source_file}.replace_extension();
+        if (binary == source_file)
+            binary += ".out";
+
+        std::vector<std::string> args;
+        const char* compiler = std::getenv("CXX");
+        std::istringstream compiler_words{compiler ? compiler : ""};
+        for (std::string word; compiler_words >> word;)
+            args.push_back(word);
+        if (args.empty())
+            args.push_back("c++");
+        args.insert(args.end(), {"-std=c++20", "-O2", "-o", binary.string(), source_file});
+
+        int status = run_process(args);
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            return binary.string();
+
+        std::string reason = WIFEXITED(status) ? "exit status " + std::to_string(WEXITSTATUS(status))
+                                               : "signal "      + std::to_string(WTERMSIG(status));
+        throw error_t{str_red("compilation of emitted program by " + args[0] + " failed with " + reason)};
+    }
+}
\ No newline at end of file
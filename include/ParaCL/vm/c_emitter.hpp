@@ -0,0 +1,477 @@
+#pragma once
+
+#include "ParaCL/node.hpp"
+#include "ParaCL/vm/bytecode.hpp"
+#include "ParaCL/vm/c_runtime.hpp"
+
+#include <iomanip>
+
+namespace paracl {
+    // translates bytecode to c++, every instruction becomes statement with known depth of stack,
+    // so values on stack are accessed by constant offsets and jumps become gotos
+    class c_emitter_t final {
+        static constexpr int unreachable = -1;
+
+        const bytecode_t& code_;
+        std::string_view  program_str_;
+
+        std::vector<int>  depths_; // depth of stack before instruction
+        std::vector<bool> is_labels_;
+        std::vector<int>  sites_;  // first error message of instruction
+        std::vector<std::string> errors_;
+        std::vector<int>  return_points_;
+        int max_depth_ = 1;
+
+    private:
+        static std::string quote(std::string_view str) {
+            std::ostringstream oss;
+            oss << '"';
+            for (unsigned char c : str) {
+                if (c == '"' || c == '\\')
+                    oss << '\\' << c;
+                else if (c >= ' ' && c < 127)
+                    oss << c;
+                else
+                    oss << '\\' << std::oct << std::setw(3) << std::setfill('0') << int(c) << std::dec;
+            }
+            oss << '"';
+            return oss.str();
+        }
+
+        static bool is_indexing(opcode_e op) {
+            return op == opcode_e::LOAD_INDEXED || op == opcode_e::STORE_INDEXED || op == opcode_e::INDEX;
+        }
+
+        static bool can_fail(opcode_e op) {
+            switch (op) {
+                case opcode_e::PUSH_INT:
+                case opcode_e::PUSH_UNDEF:
+                case opcode_e::PUSH_FUNCTION:
+                case opcode_e::POP:
+                case opcode_e::LOAD:
+                case opcode_e::STORE:
+                case opcode_e::NEW_ARRAY:
+                case opcode_e::NEW_CONSTANTS:
+                case opcode_e::NEW_MAP:
+                case opcode_e::ARRAY_APPEND:
+                case opcode_e::PRINT:
+                case opcode_e::JUMP:
+                case opcode_e::JUMP_IF_UNDEF:
+                case opcode_e::RET:
+                case opcode_e::HALT: return false;
+                default: return true;
+            }
+        }
+
+        int target(int position) const { return position + code_[position].arg; }
+
+        void add_path(int position, int depth, std::vector<std::pair<int, int>>& paths) {
+            max_depth_ = std::max(max_depth_, depth + 1);
+            paths.emplace_back(position, depth);
+        }
+
+        // depth after instruction for every instruction, which can be executed next
+        void add_next(int position, int depth, std::vector<std::pair<int, int>>& paths) {
+            const instruction_t& instruction = code_[position];
+            int next = position + 1;
+            switch (instruction.op) {
+                case opcode_e::PUSH_INT:
+                case opcode_e::PUSH_UNDEF:
+                case opcode_e::PUSH_FUNCTION:
+                case opcode_e::INPUT:
+                case opcode_e::LOAD:
+                case opcode_e::NEW_ARRAY:
+                case opcode_e::NEW_CONSTANTS:
+                case opcode_e::NEW_MAP: add_path(next, depth + 1, paths); break;
+
+                case opcode_e::LOAD_INDEXED: add_path(next, depth - instruction.extra + 1, paths); break;
+
+                case opcode_e::STORE_INDEXED:
+                case opcode_e::INDEX:
+                case opcode_e::CALL: add_path(next, depth - instruction.extra, paths); break;
+
+                case opcode_e::ARRAY_APPEND_REPEAT:
+                case opcode_e::SLICE: add_path(next, depth - 2, paths); break;
+
+                case opcode_e::POP:
+                case opcode_e::NEW_REPEAT:
+                case opcode_e::ARRAY_APPEND:
+                case opcode_e::ARRAY_PUSH:
+                case opcode_e::EQ:
+                case opcode_e::NE:
+                case opcode_e::LE:
+                case opcode_e::GE:
+                case opcode_e::LT:
+                case opcode_e::GT:
+                case opcode_e::ADD:
+                case opcode_e::SUB:
+                case opcode_e::MUL:
+                case opcode_e::DIV:
+                case opcode_e::MOD: add_path(next, depth - 1, paths); break;
+
+                case opcode_e::STORE:
+                case opcode_e::ARRAY_POP:
+                case opcode_e::ARRAY_LEN:
+                case opcode_e::TO_BOOL:
+                case opcode_e::POS:
+                case opcode_e::NEG:
+                case opcode_e::NOT:
+                case opcode_e::PRINT: add_path(next, depth, paths); break;
+
+                // left operand stays on stack only when it decides result
+                case opcode_e::OR_LEFT:
+                case opcode_e::AND_LEFT: {
+                    add_path(target(position), depth, paths);
+                    add_path(next, depth - 1, paths);
+                    break;
+                }
+
+                case opcode_e::JUMP: add_path(target(position), depth, paths); break;
+                case opcode_e::JUMP_IF_UNDEF: {
+                    add_path(target(position), depth, paths);
+                    add_path(next, depth, paths);
+                    break;
+                }
+                case opcode_e::JUMP_IF_FALSE:
+                case opcode_e::JUMP_IF_TRUE: {
+                    add_path(target(position), depth - 1, paths);
+                    add_path(next, depth - 1, paths);
+                    break;
+                }
+
+                case opcode_e::TAIL_CALL:
+                case opcode_e::RET:
+                case opcode_e::MISSING_RETURN:
+                case opcode_e::HALT: break;
+
+                default: throw error_t{str_red("c_emitter_t: add_next() failed: unknown opcode")};
+            }
+        }
+
+        // body of every function starts on empty stack above its caller
+        void compute_depths() {
+            std::vector<std::pair<int, int>> paths;
+            add_path(0, 0, paths);
+            for (size_t i = 0; i < code_.count_functions(); ++i)
+                if (int entry = code_.function(i).entry; entry >= 0)
+                    add_path(entry, 0, paths);
+
+            while (!paths.empty()) {
+                auto [position, depth] = paths.back();
+                paths.pop_back();
+
+                if (depths_[position] != unreachable) {
+                    if (depths_[position] != depth)
+                        throw error_t{str_red("c_emitter_t: compute_depths() failed: different depths of stack")};
+                    continue;
+                }
+                depths_[position] = depth;
+                add_next(position, depth, paths);
+            }
+        }
+
+        void add_label(int position) {
+            assert(position >= 0 && position < code_.size());
+            is_labels_[position] = true;
+        }
+
+        void collect_labels() {
+            for (int i = 0; i < code_.size(); ++i) {
+                if (depths_[i] == unreachable)
+                    continue;
+
+                switch (code_[i].op) {
+                    case opcode_e::OR_LEFT:
+                    case opcode_e::AND_LEFT:
+                    case opcode_e::JUMP:
+                    case opcode_e::JUMP_IF_UNDEF:
+                    case opcode_e::JUMP_IF_FALSE:
+                    case opcode_e::JUMP_IF_TRUE: add_label(target(i)); break;
+                    case opcode_e::CALL: add_label(i + 1); return_points_.push_back(i + 1); break;
+                    default: break;
+                }
+            }
+
+            for (size_t i = 0; i < code_.count_functions(); ++i)
+                if (int entry = code_.function(i).entry; entry >= 0 && depths_[entry] != unreachable)
+                    add_label(entry);
+        }
+
+        // messages of errors are formatted once here as in error_execute_t, only reason is added at runtime
+        void collect_errors() {
+            for (int i = 0; i < code_.size(); ++i) {
+                if (depths_[i] == unreachable || !can_fail(code_[i].op))
+                    continue;
+
+                sites_[i] = errors_.size();
+                const node_loc_t* source = code_.source(i);
+                if (!is_indexing(code_[i].op)) {
+                    errors_.push_back(get_error_line(source->loc(), program_str_));
+                    continue;
+                }
+
+                auto indexes = static_cast<const node_indexes_t*>(source);
+                for (int depth = 0; depth < code_[i].extra; ++depth)
+                    errors_.push_back(get_error_line(indexes->get_index_loc(depth), program_str_));
+            }
+        }
+
+        void emit_tables(std::ostream& os) const {
+            os << "namespace {\n";
+            os << "    struct function_t final {\n"
+               << "        const char* name;\n"
+               << "        int frame_begin;\n"
+               << "        int count_args;\n"
+               << "        int count_slots;\n"
+               << "    };\n\n";
+
+            os << "    const function_t functions[] = {\n";
+            for (size_t i = 0; i < code_.count_functions(); ++i) {
+                const function_info_t& function = code_.function(i);
+                os << "        {" << quote(function.name) << ", " << function.frame_begin << ", "
+                   << function.count_args << ", " << function.count_slots << "},\n";
+            }
+            os << "        {\"\", 0, 0, 0}\n";
+            os << "    };\n\n";
+
+            os << "    const char* const errors[] = {\n";
+            for (const std::string& error : errors_)
+                os << "        " << quote(error) << ",\n";
+            os << "        \"\"\n";
+            os << "    };\n\n";
+
+            os << "    const int constants[] = {";
+            for (int constant : code_.constants())
+                os << constant << ", ";
+            os << "0};\n\n";
+
+            os << "    constexpr int    count_slots = " << code_.count_slots() << ";\n";
+            os << "    constexpr size_t max_depth   = " << max_depth_ << ";\n";
+            os << "}\n";
+        }
+
+        static std::string binary_lambda(opcode_e op) {
+            switch (op) {
+                case opcode_e::EQ:  return "[](int lhs, int rhs) { return int(lhs == rhs); }";
+                case opcode_e::NE:  return "[](int lhs, int rhs) { return int(lhs != rhs); }";
+                case opcode_e::LE:  return "[](int lhs, int rhs) { return int(lhs <= rhs); }";
+                case opcode_e::GE:  return "[](int lhs, int rhs) { return int(lhs >= rhs); }";
+                case opcode_e::LT:  return "[](int lhs, int rhs) { return int(lhs <  rhs); }";
+                case opcode_e::GT:  return "[](int lhs, int rhs) { return int(lhs >  rhs); }";
+                case opcode_e::ADD: return "[](int lhs, int rhs) { return lhs + rhs; }";
+                case opcode_e::SUB: return "[](int lhs, int rhs) { return lhs - rhs; }";
+                case opcode_e::MUL: return "[](int lhs, int rhs) { return lhs * rhs; }";
+                case opcode_e::DIV: return "[](int lhs, int rhs) { return lhs / rhs; }";
+                case opcode_e::MOD: return "[](int lhs, int rhs) { return lhs % rhs; }";
+                default: throw error_t{str_red("c_emitter_t: binary_lambda() failed: not binary opcode")};
+            }
+        }
+
+        static std::string unary_lambda(opcode_e op) {
+            switch (op) {
+                case opcode_e::TO_BOOL: return "[](int value) { return int(value != 0); }";
+                case opcode_e::POS:     return "[](int value) { return value; }";
+                case opcode_e::NEG:     return "[](int value) { return -value; }";
+                case opcode_e::NOT:     return "[](int value) { return int(!value); }";
+                default: throw error_t{str_red("c_emitter_t: unary_lambda() failed: not unary opcode")};
+            }
+        }
+
+        void emit_instruction(int position, std::ostream& os) const {
+            const instruction_t& instruction = code_[position];
+            int depth = depths_[position];
+            int site  = sites_[position];
+            int count = instruction.extra;
+            auto sp = [depth](int offset) { return "sp[" + std::to_string(depth + offset) + "]"; };
+            auto top = "sp + " + std::to_string(depth);
+            auto jump = [this, position]() { return "goto L" + std::to_string(target(position)) + ";"; };
+
+            os << "    ";
+            switch (instruction.op) {
+                case opcode_e::PUSH_INT:      os << sp(0) << " = make_int(" << instruction.arg << ");"; break;
+                case opcode_e::PUSH_UNDEF:    os << sp(0) << " = value_t{};"; break;
+                case opcode_e::PUSH_FUNCTION: os << sp(0) << " = make_function(" << instruction.arg << ");"; break;
+                case opcode_e::INPUT:         os << sp(0) << " = input(" << site << ");"; break;
+                case opcode_e::POP:           os << ";"; break;
+
+                case opcode_e::LOAD:  os << sp(0) << " = rt.slots[" << instruction.arg << "];"; break;
+                case opcode_e::STORE: os << "rt.slots[" << instruction.arg << "] = " << sp(-1) << ";"; break;
+                case opcode_e::LOAD_INDEXED: {
+                    os << sp(-count) << " = runtime_t::shift(rt.slots[" << instruction.arg << "], "
+                       << top << " - " << count << ", " << count << ", " << site << ", "
+                       << int{instruction.in_bounds} << ");";
+                    break;
+                }
+                case opcode_e::STORE_INDEXED: {
+                    os << "runtime_t::shift(rt.slots[" << instruction.arg << "], "
+                       << top << " - " << count << ", " << count << ", " << site << ", "
+                       << int{instruction.in_bounds} << ", true) = " << sp(-count - 1) << ";";
+                    break;
+                }
+                case opcode_e::INDEX: {
+                    os << "{ value_t array = " << sp(-count - 1) << "; " << sp(-count - 1)
+                       << " = runtime_t::shift(array, " << top << " - " << count << ", " << count << ", " << site << "); }";
+                    break;
+                }
+
+                case opcode_e::NEW_ARRAY: {
+                    os << "rt.collect_garbage(" << top << "); " << sp(0) << " = make_array(rt.new_array());";
+                    break;
+                }
+                case opcode_e::NEW_CONSTANTS: {
+                    os << "rt.collect_garbage(" << top << "); " << sp(0) << " = make_array(rt.new_constants("
+                       << instruction.arg << ", " << count << "));";
+                    break;
+                }
+                case opcode_e::NEW_MAP: {
+                    os << "rt.collect_garbage(" << top << "); " << sp(0) << " = make_map(rt.new_map());";
+                    break;
+                }
+                case opcode_e::NEW_REPEAT: {
+                    os << "rt.collect_garbage(" << top << "); "
+                       << sp(-2) << " = rt.new_repeat(" << sp(-2) << ", " << sp(-1) << ", " << site << ");";
+                    break;
+                }
+                case opcode_e::ARRAY_APPEND: os << sp(-2) << ".array->values.push_back(" << sp(-1) << ");"; break;
+                case opcode_e::ARRAY_APPEND_REPEAT: {
+                    os << "rt.collect_garbage(" << top << "); rt.append_repeat("
+                       << sp(-3) << ".array, " << sp(-2) << ", " << sp(-1) << ", " << site << ");";
+                    break;
+                }
+                case opcode_e::SLICE: {
+                    os << "rt.collect_garbage(" << top << "); "
+                       << sp(-3) << " = rt.slice(" << sp(-3) << ", " << sp(-2) << ", " << sp(-1) << ", " << site << ");";
+                    break;
+                }
+                case opcode_e::ARRAY_PUSH: {
+                    os << sp(-2) << " = runtime_t::push(" << sp(-2) << ", " << sp(-1) << ", " << site << ");";
+                    break;
+                }
+                case opcode_e::ARRAY_POP: os << sp(-1) << " = runtime_t::pop(" << sp(-1) << ", " << site << ");"; break;
+                case opcode_e::ARRAY_LEN: os << sp(-1) << " = runtime_t::len(" << sp(-1) << ", " << site << ");"; break;
+
+                case opcode_e::EQ:
+                case opcode_e::NE:
+                case opcode_e::LE:
+                case opcode_e::GE:
+                case opcode_e::LT:
+                case opcode_e::GT:
+                case opcode_e::ADD:
+                case opcode_e::SUB:
+                case opcode_e::MUL:
+                case opcode_e::DIV:
+                case opcode_e::MOD: {
+                    os << "rt.binary(" << sp(-2) << ", " << sp(-1) << ", " << binary_lambda(instruction.op)
+                       << ", " << top << ", " << site << ");";
+                    break;
+                }
+
+                case opcode_e::OR_LEFT:
+                case opcode_e::AND_LEFT: {
+                    bool is_or = (instruction.op == opcode_e::OR_LEFT);
+                    os << "if (logic_left(" << sp(-1) << ", " << (is_or ? "true" : "false") << ", "
+                       << site << ")) " << jump();
+                    break;
+                }
+
+                case opcode_e::TO_BOOL: {
+                    os << "unary(" << sp(-1) << ", " << unary_lambda(instruction.op) << ", " << site << ");";
+                    break;
+                }
+                case opcode_e::POS:
+                case opcode_e::NEG:
+                case opcode_e::NOT: {
+                    os << "rt.unary(" << sp(-1) << ", " << unary_lambda(instruction.op) << ", "
+                       << top << ", " << site << ");";
+                    break;
+                }
+
+                case opcode_e::PRINT: os << "print(" << sp(-1) << ", std::cout); std::cout << '\\n';"; break;
+
+                case opcode_e::JUMP: os << jump(); break;
+                case opcode_e::JUMP_IF_UNDEF: os << "if (" << sp(-1) << ".type == type_e::UNDEF) " << jump(); break;
+                case opcode_e::JUMP_IF_FALSE: os << "if (!condition(" << sp(-1) << ", " << site << ")) " << jump(); break;
+                case opcode_e::JUMP_IF_TRUE:  os << "if (condition("  << sp(-1) << ", " << site << ")) " << jump(); break;
+
+                case opcode_e::CALL: {
+                    os << "sp = rt.call(sp, " << depth << ", " << count << ", " << position + 1
+                       << ", function, " << site << "); goto enter_function;";
+                    break;
+                }
+                case opcode_e::TAIL_CALL: {
+                    os << "sp = rt.tail_call(sp, " << depth << ", " << count
+                       << ", function, " << site << "); goto enter_function;";
+                    break;
+                }
+                case opcode_e::RET: os << "sp = rt.ret(sp, return_point); goto return_to_caller;"; break;
+
+                case opcode_e::MISSING_RETURN: os << "fail(" << site << ", \"missing return value\");"; break;
+                case opcode_e::HALT: os << "return;"; break;
+
+                default: throw error_t{str_red("c_emitter_t: emit_instruction() failed: unknown opcode")};
+            }
+            os << '\n';
+        }
+
+        void emit_dispatch(std::ostream& os) const {
+            os << "enter_function:\n";
+            os << "    switch (function) {\n";
+            for (size_t i = 0; i < code_.count_functions(); ++i)
+                if (int entry = code_.function(i).entry; entry >= 0 && depths_[entry] != unreachable)
+                    os << "        case " << i << ": goto L" << entry << ";\n";
+            os << "        default: std::abort();\n";
+            os << "    }\n";
+
+            os << "return_to_caller:\n";
+            os << "    switch (return_point) {\n";
+            for (int point : return_points_)
+                os << "        case " << point << ": goto L" << point << ";\n";
+            os << "        default: std::abort();\n";
+            os << "    }\n";
+        }
+
+        void emit_run(std::ostream& os) const {
+            os << "void run(runtime_t& rt) {\n";
+            os << "    value_t* sp = rt.base();\n";
+            os << "    [[maybe_unused]] int function = 0;\n";
+            os << "    [[maybe_unused]] int return_point = 0;\n\n";
+
+            for (int i = 0; i < code_.size(); ++i) {
+                if (depths_[i] == unreachable)
+                    continue;
+                if (is_labels_[i])
+                    os << "L" << i << ":\n";
+                emit_instruction(i, os);
+            }
+
+            if (code_.count_functions() > 0) {
+                os << '\n';
+                emit_dispatch(os);
+            }
+            os << "}\n";
+        }
+
+    public:
+        c_emitter_t(const bytecode_t& code, std::string_view program_str)
+        : code_(code), program_str_(program_str),
+          depths_(code.size(), unreachable), is_labels_(code.size()), sites_(code.size()) {
+            compute_depths();
+            collect_labels();
+            collect_errors();
+        }
+
+        void emit(std::ostream& os) const {
+            os << "// generated by paracl, runtime follows semantics of its vm\n\n";
+            os << "#include <cstddef>\n\n";
+            emit_tables(os);
+            os << c_runtime << '\n';
+            os << "namespace {\n";
+            emit_run(os);
+            os << "}\n\n";
+            os << "int main() {\n";
+            os << "    static runtime_t rt;\n";
+            os << "    run(rt);\n";
+            os << "}\n";
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,660 @@
+#pragma once
+
+#include <string_view>
+
+namespace paracl {
+    // runtime of translation unit emitted by c_emitter_t, it follows semantics of vm_t,
+    // program tables (errors, functions, count_slots, max_depth) are emitted before it
+    inline constexpr std::string_view c_runtime = R"runtime(
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    enum class type_e { INTEGER, UNDEF, ARRAY, FUNCTION, MAP };
+
+    struct array_t;
+    struct map_t;
+
+    struct value_t final {
+        type_e type = type_e::UNDEF;
+        union {
+            int      number = 0;
+            int      function;
+            array_t* array;
+            map_t*   map;
+        };
+    };
+
+    // elements of repeat are its value until they are written, pages of them are materialized
+    // on first write as in lazy_values_t
+    struct lazy_t final {
+        static constexpr int page_size = 256;
+
+        int     size = 0;
+        value_t value;
+        std::vector<std::vector<value_t>> pages;
+
+        value_t& at(int index, bool is_write) {
+            size_t page = index / page_size;
+            if (page < pages.size() && !pages[page].empty())
+                return pages[page][index % page_size];
+            if (!is_write)
+                return value;
+
+            if (page >= pages.size())
+                pages.resize(page + 1);
+            pages[page].assign(std::min(page_size, size - static_cast<int>(page) * page_size), value);
+            return pages[page][index % page_size];
+        }
+
+        const value_t& get(int index) const {
+            size_t page = index / page_size;
+            if (page < pages.size() && !pages[page].empty())
+                return pages[page][index % page_size];
+            return value;
+        }
+
+        // value of untouched elements and every materialized one
+        template <typename FuncT>
+        void for_each_distinct(FuncT func) {
+            func(value);
+            for (std::vector<value_t>& page : pages)
+                std::for_each(page.begin(), page.end(), func);
+        }
+    };
+
+    // slice has no values of its own, it is view over length values of base from offset,
+    // which keeps in bounds of base shrunk by pop. repeat of value, which is not array,
+    // keeps it once in lazy values until array is resized
+    struct array_t final {
+        std::vector<value_t> values;
+        lazy_t   lazy;
+        bool     is_lazy = false;
+        array_t* base   = nullptr;
+        int      offset = 0;
+        int      length = 0;
+        bool is_marked = false;
+
+        int size() const {
+            if (base)
+                return std::clamp(base->size() - offset, 0, length);
+            return is_lazy ? lazy.size : static_cast<int>(values.size());
+        }
+
+        // element of repeat is materialized only for write
+        value_t& at(int index, bool is_write) {
+            if (base)
+                return base->at(offset + index, is_write);
+            return is_lazy ? lazy.at(index, is_write) : values[index];
+        }
+
+        const value_t& operator[](int index) const {
+            if (base)
+                return (*base)[offset + index];
+            return is_lazy ? lazy.get(index) : values[index];
+        }
+
+        // push and pop need values one after another
+        void materialize() {
+            if (!is_lazy)
+                return;
+            values.reserve(lazy.size);
+            for (int i = 0; i < lazy.size; ++i)
+                values.push_back(lazy.get(i));
+            lazy    = {};
+            is_lazy = false;
+        }
+    };
+
+    // open addressing with linear probing by integer keys, at most half of slots are used
+    struct map_t final {
+        struct slot_t final {
+            int     key     = 0;
+            bool    is_used = false;
+            value_t value;
+        };
+
+        std::vector<slot_t> slots;
+        int  count     = 0;
+        int  shift     = 0;
+        bool is_marked = false;
+
+        slot_t& probe(int key) {
+            const size_t mask = slots.size() - 1;
+            for (size_t i = static_cast<uint32_t>(static_cast<uint32_t>(key) * 2654435769u) >> shift;; i = (i + 1) & mask)
+                if (!slots[i].is_used || slots[i].key == key)
+                    return slots[i];
+        }
+
+        value_t* find(int key) {
+            if (slots.empty())
+                return nullptr;
+            slot_t& slot = probe(key);
+            return slot.is_used ? &slot.value : nullptr;
+        }
+
+        value_t& operator[](int key) {
+            if (value_t* value = find(key))
+                return *value;
+
+            if (2 * (count + 1) > static_cast<int>(slots.size())) {
+                std::vector<slot_t> old = std::move(slots);
+                slots.assign(old.empty() ? 8 : 2 * old.size(), slot_t{});
+                shift = 32 - std::countr_zero(slots.size());
+                for (const slot_t& slot : old)
+                    if (slot.is_used)
+                        probe(slot.key) = slot;
+            }
+            slot_t& slot = probe(key);
+            slot.key     = key;
+            slot.is_used = true;
+            ++count;
+            return slot.value;
+        }
+    };
+
+    std::string type2str(type_e type) {
+        switch (type) {
+            case type_e::INTEGER:  return "integer";
+            case type_e::UNDEF:    return "undef";
+            case type_e::ARRAY:    return "array";
+            case type_e::FUNCTION: return "function";
+            case type_e::MAP:      return "map";
+            default:               return "unknown type";
+        }
+    }
+
+    [[noreturn]] void fail(int site, const std::string& msg) {
+        std::cout << errors[site] << "\033[31m\033[31mexecution failed: " << msg << "\033[0m\033[0m" << '\n';
+        std::exit(1);
+    }
+
+    inline value_t make_int(int number) {
+        value_t value;
+        value.type   = type_e::INTEGER;
+        value.number = number;
+        return value;
+    }
+
+    inline value_t make_function(int function) {
+        value_t value;
+        value.type     = type_e::FUNCTION;
+        value.function = function;
+        return value;
+    }
+
+    inline value_t make_array(array_t* array) {
+        value_t value;
+        value.type  = type_e::ARRAY;
+        value.array = array;
+        return value;
+    }
+
+    inline value_t make_map(map_t* map) {
+        value_t value;
+        value.type = type_e::MAP;
+        value.map  = map;
+        return value;
+    }
+
+    inline void expect_integer(const value_t& value, int site) {
+        if (value.type != type_e::INTEGER) [[unlikely]]
+            fail(site, "wrong type: " + type2str(value.type));
+    }
+
+    template <typename FuncT>
+    inline void binary(value_t& lhs, const value_t& rhs, FuncT func, int site) {
+        if (lhs.type == type_e::UNDEF)
+            return;
+
+        if (rhs.type == type_e::UNDEF) {
+            lhs.type = type_e::UNDEF;
+            return;
+        }
+
+        expect_integer(lhs, site);
+        expect_integer(rhs, site);
+        lhs.number = func(lhs.number, rhs.number);
+    }
+
+    template <typename FuncT>
+    inline void unary(value_t& value, FuncT func, int site) {
+        if (value.type == type_e::UNDEF)
+            return;
+        expect_integer(value, site);
+        value.number = func(value.number);
+    }
+
+    inline bool condition(const value_t& value, int site) {
+        if (value.type == type_e::UNDEF) [[unlikely]]
+            fail(site, "wrong type: undef, excpected int");
+        expect_integer(value, site);
+        return value.number;
+    }
+
+    // returns 1 if left operand decides result of || or &&, then it stays on stack
+    inline bool logic_left(const value_t& lhs, bool is_or, int site) {
+        if (lhs.type == type_e::UNDEF)
+            return true;
+        expect_integer(lhs, site);
+        return (lhs.number != 0) == is_or;
+    }
+
+    value_t input(int site) {
+        int value;
+        std::cin >> value;
+        if (!std::cin.good())
+            fail(site, "invalid input: need integer");
+        return make_int(value);
+    }
+
+    void print(const value_t& value, std::ostream& os) {
+        switch (value.type) {
+            case type_e::INTEGER:  os << value.number; break;
+            case type_e::UNDEF:    os << "undef"; break;
+            case type_e::FUNCTION: os << "function " << functions[value.function].name; break;
+            case type_e::ARRAY: {
+                os << '[';
+                bool is_first = true;
+                const array_t& array = *value.array;
+                for (int i = 0; i < array.size(); ++i) {
+                    if (!is_first)
+                        os << ", ";
+                    is_first = false;
+                    print(array[i], os);
+                }
+                os << ']';
+                break;
+            }
+            case type_e::MAP: {
+                std::vector<const map_t::slot_t*> slots;
+                for (const map_t::slot_t& slot : value.map->slots)
+                    if (slot.is_used)
+                        slots.push_back(&slot);
+                std::ranges::sort(slots, {}, &map_t::slot_t::key);
+
+                os << '{';
+                bool is_first = true;
+                for (const map_t::slot_t* slot : slots) {
+                    if (!is_first)
+                        os << ", ";
+                    is_first = false;
+                    os << slot->key << ": ";
+                    print(slot->value, os);
+                }
+                os << '}';
+                break;
+            }
+        }
+    }
+
+    class runtime_t final {
+        struct frame_t final {
+            int    return_point;
+            size_t saved_begin;
+            int    function;
+            size_t caller_base;
+        };
+
+        std::vector<value_t> stack_;
+        std::vector<value_t> saved_;
+        std::vector<frame_t> frames_;
+
+        std::vector<std::unique_ptr<array_t>> heap_;
+        std::vector<std::unique_ptr<map_t>>   maps_;
+        size_t collect_threshold_ = min_collect_threshold_;
+        size_t count_values_      = 0; // values of arrays filled at once since last collection
+        size_t values_threshold_  = min_values_threshold_;
+
+        static constexpr size_t min_collect_threshold_ = 1024;
+        static constexpr size_t min_values_threshold_  = 1 << 20;
+
+    public:
+        value_t slots[count_slots + 1];
+
+    private:
+        static void mark_array(array_t* array) {
+            if (array->is_marked)
+                return;
+
+            array->is_marked = true;
+            if (array->base)
+                mark_array(array->base);
+            for (const value_t& elem : array->values)
+                mark(elem);
+            if (array->is_lazy)
+                array->lazy.for_each_distinct(mark);
+        }
+
+        static void mark(const value_t& value) {
+            if (value.type == type_e::ARRAY)
+                mark_array(value.array);
+            else if (value.type == type_e::MAP)
+                value.map->is_marked = true; // values of map are integers
+        }
+
+        value_t deep_copy(const value_t& value) {
+            if (value.type != type_e::ARRAY)
+                return value;
+
+            value_t copy = value;
+            copy.array = new_array();
+            const array_t& array = *value.array;
+            if (array.is_lazy) {
+                copy.array->lazy    = array.lazy;
+                copy.array->is_lazy = true;
+                copy.array->lazy.for_each_distinct([this](value_t& elem) { elem = deep_copy(elem); });
+                return copy;
+            }
+            copy.array->values.reserve(array.size());
+            for (int i = 0; i < array.size(); ++i)
+                copy.array->values.push_back(deep_copy(array[i]));
+            return copy;
+        }
+
+        template <typename FuncT>
+        value_t elementwise(const value_t& lhs, const value_t& rhs, FuncT func, int site) {
+            if (lhs.type == type_e::UNDEF || rhs.type == type_e::UNDEF)
+                return value_t{};
+
+            if (lhs.type != type_e::ARRAY && rhs.type != type_e::ARRAY) {
+                expect_integer(lhs, site);
+                expect_integer(rhs, site);
+                return make_int(func(lhs.number, rhs.number));
+            }
+
+            const array_t* l_array = lhs.type == type_e::ARRAY ? lhs.array : nullptr;
+            const array_t* r_array = rhs.type == type_e::ARRAY ? rhs.array : nullptr;
+            const int size = l_array ? l_array->size() : r_array->size();
+            if (l_array && r_array && r_array->size() != size)
+                fail(site,   "different sizes of arrays in operator: \"" + std::to_string(size)
+                           + "\" and \"" + std::to_string(r_array->size()) + "\"");
+
+            count_values_ += size;
+            array_t* array = new_array();
+            array->values.resize(size);
+            for (int i = 0; i < size; ++i) {
+                const value_t& l_elem = l_array ? (*l_array)[i] : lhs;
+                const value_t& r_elem = r_array ? (*r_array)[i] : rhs;
+                if (l_elem.type == type_e::INTEGER && r_elem.type == type_e::INTEGER)
+                    array->values[i] = make_int(func(l_elem.number, r_elem.number));
+                else
+                    array->values[i] = elementwise(l_elem, r_elem, func, site);
+            }
+            return make_array(array);
+        }
+
+        template <typename FuncT>
+        value_t elementwise(const value_t& value, FuncT func, int site) {
+            if (value.type == type_e::UNDEF)
+                return value;
+
+            if (value.type != type_e::ARRAY) {
+                expect_integer(value, site);
+                return make_int(func(value.number));
+            }
+
+            const array_t& array = *value.array;
+            count_values_ += array.size();
+            array_t* result = new_array();
+            result->values.reserve(array.size());
+            for (int i = 0; i < array.size(); ++i)
+                result->values.push_back(elementwise(array[i], func, site));
+            return make_array(result);
+        }
+
+        value_t* enter(size_t base, int count_args, int return_point, size_t caller_base,
+                       int& function_index, int site) {
+            value_t* callee = stack_.data() + base;
+            if (callee->type != type_e::FUNCTION)
+                fail(site, "wrong type: " + type2str(callee->type));
+
+            const function_t& function = functions[callee->function];
+            if (function.count_args != count_args)
+                fail(site,   "different count of declared arguments(" + std::to_string(function.count_args)
+                           + ") and count arguments for function call(" + std::to_string(count_args) + ")");
+
+            function_index = callee->function;
+            frames_.push_back({return_point, saved_.size(), function_index, caller_base});
+            value_t* frame = slots + function.frame_begin;
+            saved_.insert(saved_.end(), frame, frame + function.count_slots);
+            for (int i = 0; i < count_args; ++i)
+                frame[i] = callee[count_args - i];
+            std::fill(frame + count_args, frame + function.count_slots, value_t{});
+
+            if (stack_.size() < base + max_depth)
+                stack_.resize(std::max(2 * stack_.size(), base + max_depth));
+            return stack_.data() + base;
+        }
+
+    public:
+        runtime_t() : stack_(max_depth) {}
+
+        value_t* base() { return stack_.data(); }
+
+        array_t* new_array() {
+            return heap_.emplace_back(std::make_unique<array_t>()).get();
+        }
+
+        map_t* new_map() {
+            return maps_.emplace_back(std::make_unique<map_t>()).get();
+        }
+
+        // array of count integers from table of constants
+        array_t* new_constants(int first, int count) {
+            count_values_ += count;
+            array_t* array = new_array();
+            array->values.resize(count);
+            for (int i = 0; i < count; ++i)
+                array->values[i] = make_int(constants[first + i]);
+            return array;
+        }
+
+        // all live arrays are reachable from stack below top, slots or saved frames
+        void collect_garbage(const value_t* top) {
+            if (heap_.size() + maps_.size() < collect_threshold_ && count_values_ < values_threshold_)
+                return;
+
+            std::for_each(static_cast<const value_t*>(stack_.data()), top, mark);
+            std::for_each(slots, slots + count_slots, mark);
+            std::ranges::for_each(saved_, mark);
+
+            std::erase_if(heap_, [](const std::unique_ptr<array_t>& array) { return !array->is_marked; });
+            size_t live_values = 0;
+            std::ranges::for_each(heap_, [&live_values](auto& array) {
+                array->is_marked = false;
+                live_values += array->values.size();
+            });
+            std::erase_if(maps_, [](const std::unique_ptr<map_t>& map) { return !map->is_marked; });
+            std::ranges::for_each(maps_, [](auto& map) { map->is_marked = false; });
+
+            collect_threshold_ = std::max(min_collect_threshold_, 2 * (heap_.size() + maps_.size()));
+            values_threshold_  = std::max(min_values_threshold_, live_values);
+            count_values_      = 0;
+        }
+
+        // arrays are combined element by element, operands below top stay roots of collection
+        template <typename FuncT>
+        void binary(value_t& lhs, const value_t& rhs, FuncT func, const value_t* top, int site) {
+            if (lhs.type != type_e::ARRAY && rhs.type != type_e::ARRAY) {
+                ::binary(lhs, rhs, func, site);
+                return;
+            }
+            collect_garbage(top);
+            lhs = elementwise(lhs, rhs, func, site);
+        }
+
+        template <typename FuncT>
+        void unary(value_t& value, FuncT func, const value_t* top, int site) {
+            if (value.type != type_e::ARRAY) {
+                ::unary(value, func, site);
+                return;
+            }
+            collect_garbage(top);
+            value = elementwise(value, func, site);
+        }
+
+        static void expect_repeat_count(const value_t& count, int site) {
+            expect_integer(count, site);
+            if (count.number <= 0)
+                fail(site,   "wrong input size of repeat: \"" + std::to_string(count.number) + '\"'
+                           + ", less then 0");
+        }
+
+        // repeat of value, which is not array, keeps it once as in vm, copies of array are made at once
+        value_t new_repeat(const value_t& count, const value_t& init, int site) {
+            value_t value = make_array(new_array());
+            if (init.type == type_e::ARRAY) {
+                append_repeat(value.array, count, init, site);
+                return value;
+            }
+
+            expect_repeat_count(count, site);
+            value.array->lazy    = lazy_t{count.number, init};
+            value.array->is_lazy = true;
+            return value;
+        }
+
+        void append_repeat(array_t* array, const value_t& count, const value_t& value, int site) {
+            expect_repeat_count(count, site);
+            count_values_ += count.number;
+            array->values.reserve(array->values.size() + count.number);
+            for (int i = 0; i < count.number; ++i)
+                array->values.push_back(deep_copy(value));
+        }
+
+        // slice of slice is view over the same base
+        value_t slice(const value_t& value, const value_t& begin, const value_t& end, int site) {
+            if (value.type != type_e::ARRAY)
+                fail(site, "wrong type: " + type2str(value.type));
+            expect_integer(begin, site);
+            expect_integer(end, site);
+
+            const array_t& array = *value.array;
+            if (begin.number < 0 || begin.number >= end.number || end.number > array.size())
+                fail(site,   "wrong bounds of slice: \"" + std::to_string(begin.number) + ':'
+                           + std::to_string(end.number) + "\", when array size: \""
+                           + std::to_string(array.size()) + "\"");
+
+            array_t* view = new_array();
+            view->base   = array.base ? array.base : value.array;
+            view->offset = array.offset + begin.number;
+            view->length = end.number - begin.number;
+            return make_array(view);
+        }
+
+        // push and pop resize array in place, slice is view over fixed place of its base
+        static array_t& growable(const value_t& value, int site) {
+            if (value.type != type_e::ARRAY)
+                fail(site, "wrong type: " + type2str(value.type));
+            if (value.array->base)
+                fail(site, "attempt to resize slice of array");
+            value.array->materialize();
+            return *value.array;
+        }
+
+        static value_t push(const value_t& array, const value_t& value, int site) {
+            std::vector<value_t>& values = growable(array, site).values;
+            values.push_back(value);
+            return make_int(values.size());
+        }
+
+        static value_t pop(const value_t& array, int site) {
+            std::vector<value_t>& values = growable(array, site).values;
+            if (values.empty())
+                fail(site, "attempt to pop from empty array");
+            value_t value = values.back();
+            values.pop_back();
+            return value;
+        }
+
+        static value_t len(const value_t& array, int site) {
+            if (array.type == type_e::MAP)
+                return make_int(array.map->count);
+            if (array.type != type_e::ARRAY)
+                fail(site, "wrong type: " + type2str(array.type));
+            return make_int(array.array->size());
+        }
+
+        // the first index is key of map, write inserts key, read of missing key gives 0
+        static value_t& shift_map(map_t& map, const value_t& key, int site, bool is_write) {
+            static value_t missing;
+            if (key.type != type_e::INTEGER)
+                fail(site, "wrong type: " + type2str(key.type));
+
+            value_t* result = is_write ? &map[key.number] : map.find(key.number);
+            if (result)
+                return *result;
+            return missing = make_int(0);
+        }
+
+        // site of every index follows site of the first one, extra indexes are ignored as in vm,
+        // indexes proven by analysis are not checked
+        static value_t& shift(value_t& value, const value_t* indexes, int count, int site, int in_bounds = 0,
+                              bool is_write = false) {
+            if (value.type == type_e::MAP)
+                return shift_map(*value.map, indexes[0], site, is_write);
+
+            value_t* result = &value;
+            if (result->type != type_e::ARRAY)
+                fail(site, "wrong type: " + type2str(result->type));
+
+            for (int depth = 0; depth < count; ++depth) {
+                const value_t& index = indexes[depth];
+                if (index.type != type_e::INTEGER)
+                    fail(site + depth, "wrong type: " + type2str(index.type));
+
+                array_t& array = *result->array;
+                if (!(in_bounds >> depth & 1)) {
+                    int array_size = array.size();
+                    if (index.number < 0)
+                        fail(site + depth,   "wrong index in array: \"" + std::to_string(index.number)
+                                           + "\", less than 0");
+                    if (index.number >= array_size)
+                        fail(site + depth,   "wrong index in array: \"" + std::to_string(index.number)
+                                           + "\", when array size: \""  + std::to_string(array_size) + "\"");
+                }
+
+                result = &array.at(index.number, is_write);
+                if (result->type != type_e::ARRAY)
+                    break;
+            }
+            return *result;
+        }
+
+        // callee and arguments are on top of stack, result takes place of callee
+        value_t* call(value_t* sp, int depth, int count_args, int return_point, int& function, int site) {
+            size_t caller_base = sp - stack_.data();
+            return enter(caller_base + depth - count_args - 1, count_args, return_point, caller_base,
+                         function, site);
+        }
+
+        // callee returns right where finished caller would return
+        value_t* tail_call(value_t* sp, int depth, int count_args, int& function, int site) {
+            std::copy(sp + depth - count_args - 1, sp + depth, sp);
+            size_t base = sp - stack_.data();
+            int return_point = 0;
+            sp = ret(sp, return_point);
+            return enter(base, count_args, return_point, sp - stack_.data(), function, site);
+        }
+
+        value_t* ret(value_t* sp, int& return_point) {
+            const frame_t& frame = frames_.back();
+            const function_t& function = functions[frame.function];
+            std::copy(saved_.begin() + frame.saved_begin, saved_.end(), slots + function.frame_begin);
+            saved_.resize(frame.saved_begin);
+            return_point = frame.return_point;
+            sp = stack_.data() + frame.caller_base;
+            frames_.pop_back();
+            return sp;
+        }
+    };
+}
+)runtime";
+}
\ No newline at end of file
@@ -0,0 +1,575 @@
+#pragma once
+
+#include "ParaCL/vm/bytecode.hpp"
+#include "ParaCL/vm/value.hpp"
+#include "ParaCL/vm/x86_emitter.hpp"
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <unordered_set>
+
+#if defined(__x86_64__) && defined(__unix__)
+#include <sys/mman.h>
+#endif
+
+namespace paracl {
+#if defined(__x86_64__) && defined(__unix__)
+    inline constexpr bool is_jit_supported = true;
+#else
+    inline constexpr bool is_jit_supported = false;
+#endif
+
+    // takes slots and stack of interpreter at depth of entry, returns index of exit
+    using native_code_t = int (*)(vm_value_t* slots, vm_value_t* stack);
+
+    /* ----------------------------------------------------- */
+
+    class native_memory_t final {
+        void*  data_ = nullptr;
+        size_t size_ = 0;
+
+    public:
+        explicit native_memory_t(const std::vector<uint8_t>& code) : size_(code.size()) {
+#if defined(__x86_64__) && defined(__unix__)
+            data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (data_ == MAP_FAILED)
+                throw error_t{str_red("native_memory_t: mmap failed")};
+
+            std::memcpy(data_, code.data(), size_);
+            if (mprotect(data_, size_, PROT_READ | PROT_EXEC) != 0) {
+                munmap(data_, size_);
+                throw error_t{str_red("native_memory_t: mprotect failed")};
+            }
+#else
+            throw error_t{str_red("native_memory_t: jit is not supported on this platform")};
+#endif
+        }
+
+        native_memory_t(const native_memory_t&) = delete;
+        native_memory_t& operator=(const native_memory_t&) = delete;
+
+        const uint8_t* data() const noexcept { return static_cast<const uint8_t*>(data_); }
+
+        ~native_memory_t() {
+#if defined(__x86_64__) && defined(__unix__)
+            munmap(data_, size_);
+#endif
+        }
+    };
+
+    /* ----------------------------------------------------- */
+
+    struct native_exit_t final {
+        int position;
+        int depth;
+    };
+
+    struct native_region_t;
+
+    struct native_entry_t final {
+        native_code_t code;
+        int depth; // count of values, which region takes from stack of interpreter
+        const native_region_t* region;
+    };
+
+    struct native_region_t final {
+        std::unique_ptr<native_memory_t> memory;
+        std::vector<native_exit_t>  exits;
+        std::vector<native_entry_t> entries;
+        std::vector<int> entry_positions;
+        int max_depth = 0;
+    };
+
+    /* ----------------------------------------------------- */
+
+    // translates instructions of range [begin, end) to templates of machine code,
+    // values on stack have constant offsets from its base as depth of stack is known for every instruction.
+    // instruction, which is not supported or whose operands are not integers, exits to interpreter
+    class region_compiler_t final {
+        using reg_e  = x86_emitter_t::reg_e;
+        using cond_e = x86_emitter_t::cond_e;
+        using alu_e  = x86_emitter_t::alu_e;
+
+        static constexpr int unreachable = -1;
+        static constexpr reg_e slots_reg = reg_e::RDI;
+        static constexpr reg_e stack_reg = reg_e::RSI;
+
+        static constexpr int8_t integer_type  = static_cast<int8_t>(node_type_e::INTEGER);
+        static constexpr int8_t undef_type    = static_cast<int8_t>(node_type_e::UNDEF);
+        static constexpr int    function_type = static_cast<int>(node_type_e::FUNCTION);
+
+        static_assert(sizeof(vm_value_t) == 16);
+        static constexpr int type_offset   = offsetof(vm_value_t, type);
+        static constexpr int number_offset = offsetof(vm_value_t, number);
+
+        const bytecode_t& code_;
+        int begin_;
+        int end_;
+
+        std::vector<int> depths_;
+        std::vector<int> labels_;
+        std::vector<std::pair<int, int>> entries_; // position, depth of stack
+        int  max_depth_ = 1;
+        bool is_valid_  = true;
+
+        std::vector<native_exit_t> exits_;
+        std::map<std::pair<int, int>, int> exit_ids_;
+        std::vector<std::pair<int, int>> jumps_;      // rel32, position
+        std::vector<std::pair<int, int>> exit_jumps_; // rel32, exit
+        x86_emitter_t x86_;
+
+        std::vector<bool> known_stack_;
+        std::unordered_set<int> known_slots_;
+
+    private:
+        bool in_range(int position) const noexcept { return position >= begin_ && position < end_; }
+        int& depth(int position) { return depths_[position - begin_]; }
+
+        static bool is_supported(opcode_e op) {
+            switch (op) {
+                case opcode_e::PUSH_INT:
+                case opcode_e::PUSH_UNDEF:
+                case opcode_e::PUSH_FUNCTION:
+                case opcode_e::POP:
+                case opcode_e::LOAD:
+                case opcode_e::STORE:
+                case opcode_e::EQ:
+                case opcode_e::NE:
+                case opcode_e::LE:
+                case opcode_e::GE:
+                case opcode_e::LT:
+                case opcode_e::GT:
+                case opcode_e::ADD:
+                case opcode_e::SUB:
+                case opcode_e::MUL:
+                case opcode_e::DIV:
+                case opcode_e::MOD:
+                case opcode_e::OR_LEFT:
+                case opcode_e::AND_LEFT:
+                case opcode_e::TO_BOOL:
+                case opcode_e::POS:
+                case opcode_e::NEG:
+                case opcode_e::NOT:
+                case opcode_e::JUMP:
+                case opcode_e::JUMP_IF_UNDEF:
+                case opcode_e::JUMP_IF_FALSE:
+                case opcode_e::JUMP_IF_TRUE: return true;
+                default: return false;
+            }
+        }
+
+        static bool is_jump(opcode_e op) {
+            switch (op) {
+                case opcode_e::OR_LEFT:
+                case opcode_e::AND_LEFT:
+                case opcode_e::JUMP:
+                case opcode_e::JUMP_IF_UNDEF:
+                case opcode_e::JUMP_IF_FALSE:
+                case opcode_e::JUMP_IF_TRUE: return true;
+                default: return false;
+            }
+        }
+
+        int target(int position) const { return position + code_[position].arg; }
+
+        void add_path(int position, int depth, std::vector<std::pair<int, int>>& paths) {
+            if (depth < 0) {
+                is_valid_ = false;
+                return;
+            }
+            max_depth_ = std::max(max_depth_, depth + 1);
+            if (in_range(position))
+                paths.emplace_back(position, depth);
+        }
+
+        void add_next(int position, int depth, std::vector<std::pair<int, int>>& paths) {
+            const instruction_t& instruction = code_[position];
+            int next = position + 1;
+            switch (instruction.op) {
+                case opcode_e::PUSH_INT:
+                case opcode_e::PUSH_UNDEF:
+                case opcode_e::PUSH_FUNCTION:
+                case opcode_e::LOAD: add_path(next, depth + 1, paths); break;
+
+                case opcode_e::STORE:
+                case opcode_e::TO_BOOL:
+                case opcode_e::POS:
+                case opcode_e::NEG:
+                case opcode_e::NOT: add_path(next, depth, paths); break;
+
+                case opcode_e::OR_LEFT:
+                case opcode_e::AND_LEFT: {
+                    add_path(target(position), depth, paths);
+                    add_path(next, depth - 1, paths);
+                    break;
+                }
+
+                case opcode_e::JUMP: add_path(target(position), depth, paths); break;
+                case opcode_e::JUMP_IF_UNDEF: {
+                    add_path(target(position), depth, paths);
+                    add_path(next, depth, paths);
+                    break;
+                }
+                case opcode_e::JUMP_IF_FALSE:
+                case opcode_e::JUMP_IF_TRUE: {
+                    add_path(target(position), depth - 1, paths);
+                    add_path(next, depth - 1, paths);
+                    break;
+                }
+
+                // interpreter makes call, then region continues after it
+                case opcode_e::CALL: {
+                    if (in_range(next) && depth - instruction.extra >= 0)
+                        entries_.emplace_back(next, depth - instruction.extra);
+                    break;
+                }
+
+                default: {
+                    if (is_supported(instruction.op))
+                        add_path(next, depth - 1, paths); // pop and binary operations
+                    break;
+                }
+            }
+        }
+
+        // region is entered at its beginning and at return points of calls inside it
+        void compute_depths() {
+            std::vector<std::pair<int, int>> paths;
+            entries_.emplace_back(begin_, 0);
+            for (size_t i = 0; i < entries_.size(); ++i) {
+                add_path(entries_[i].first, entries_[i].second, paths);
+                while (!paths.empty()) {
+                    auto [position, path_depth] = paths.back();
+                    paths.pop_back();
+                    if (depth(position) != unreachable) {
+                        if (depth(position) != path_depth)
+                            is_valid_ = false;
+                        continue;
+                    }
+                    depth(position) = path_depth;
+                    add_next(position, path_depth, paths);
+                }
+            }
+        }
+
+        int exit_id(int position, int depth) {
+            auto [it, is_inserted] = exit_ids_.emplace(std::make_pair(position, depth), exits_.size());
+            if (is_inserted)
+                exits_.push_back({position, depth});
+            return it->second;
+        }
+
+        // jump to instruction of region or exit to interpreter
+        void jump(int rel32, int position, int depth) {
+            if (in_range(position))
+                jumps_.emplace_back(rel32, position);
+            else
+                exit_jumps_.emplace_back(rel32, exit_id(position, depth));
+        }
+
+        void side_exit(int rel32, int position, int depth) { exit_jumps_.emplace_back(rel32, exit_id(position, depth)); }
+
+        int type_at  (int depth) const noexcept { return depth * sizeof(vm_value_t) + type_offset; }
+        int number_at(int depth) const noexcept { return depth * sizeof(vm_value_t) + number_offset; }
+        int slot_at  (int slot)  const noexcept { return slot  * sizeof(vm_value_t); }
+
+        // values, whose type is checked or produced as integer on the way from the last label
+        void forget_integers() {
+            std::fill(known_stack_.begin(), known_stack_.end(), false);
+            known_slots_.clear();
+        }
+
+        void guard_integer(int depth, int position, int current_depth) {
+            if (known_stack_[depth])
+                return;
+            x86_.cmp32_imm8(stack_reg, type_at(depth), integer_type);
+            side_exit(x86_.jcc(cond_e::NE), position, current_depth);
+            known_stack_[depth] = true;
+        }
+
+        void copy(reg_e to, int to_disp, reg_e from, int from_disp) {
+            x86_.load64 (reg_e::RAX, from, from_disp);
+            x86_.load64 (reg_e::RCX, from, from_disp + 8);
+            x86_.store64(to, to_disp,     reg_e::RAX);
+            x86_.store64(to, to_disp + 8, reg_e::RCX);
+        }
+
+        void emit_binary(opcode_e op, int position, int depth) {
+            int lhs = depth - 2;
+            int rhs = depth - 1;
+            guard_integer(lhs, position, depth);
+            guard_integer(rhs, position, depth);
+            x86_.load32(reg_e::RAX, stack_reg, number_at(lhs));
+
+            reg_e result = reg_e::RAX;
+            switch (op) {
+                case opcode_e::ADD: x86_.alu32(alu_e::ADD, stack_reg, number_at(rhs)); break;
+                case opcode_e::SUB: x86_.alu32(alu_e::SUB, stack_reg, number_at(rhs)); break;
+                case opcode_e::MUL: x86_.imul32(stack_reg, number_at(rhs)); break;
+                case opcode_e::DIV: x86_.idiv32(stack_reg, number_at(rhs)); break;
+                case opcode_e::MOD: x86_.idiv32(stack_reg, number_at(rhs)); result = reg_e::RDX; break;
+                default: {
+                    x86_.alu32(alu_e::CMP, stack_reg, number_at(rhs));
+                    x86_.set_eax(compare_cond(op));
+                    break;
+                }
+            }
+            x86_.store64(stack_reg, number_at(lhs), result);
+        }
+
+        static cond_e compare_cond(opcode_e op) {
+            switch (op) {
+                case opcode_e::EQ: return cond_e::E;
+                case opcode_e::NE: return cond_e::NE;
+                case opcode_e::LE: return cond_e::LE;
+                case opcode_e::GE: return cond_e::GE;
+                case opcode_e::LT: return cond_e::L;
+                case opcode_e::GT: return cond_e::G;
+                default: throw error_t{str_red("region_compiler_t: compare_cond() failed: not comparison")};
+            }
+        }
+
+        void emit_push(int depth, int type, int number) {
+            x86_.store_imm64(stack_reg, type_at(depth),   type);
+            x86_.store_imm64(stack_reg, number_at(depth), number);
+            known_stack_[depth] = (type == integer_type);
+        }
+
+        void emit_unary(opcode_e op, int position, int depth) {
+            int top = depth - 1;
+            guard_integer(top, position, depth);
+            if (op == opcode_e::POS)
+                return;
+
+            x86_.load32(reg_e::RAX, stack_reg, number_at(top));
+            switch (op) {
+                case opcode_e::TO_BOOL: x86_.test_set_eax(cond_e::NE); break;
+                case opcode_e::NOT:     x86_.test_set_eax(cond_e::E);  break;
+                case opcode_e::NEG:     x86_.neg_eax(); break;
+                default: throw error_t{str_red("region_compiler_t: emit_unary() failed: not unary opcode")};
+            }
+            x86_.store64(stack_reg, number_at(top), reg_e::RAX);
+        }
+
+        // integer on top of stack is compared with zero
+        void emit_branch(cond_e cond, int position, int depth, int target_depth) {
+            int top = depth - 1;
+            guard_integer(top, position, depth);
+            x86_.cmp32_imm8(stack_reg, number_at(top), 0);
+            jump(x86_.jcc(cond), target(position), target_depth);
+        }
+
+        // returns true if instruction can continue to the next one
+        bool emit_instruction(int position) {
+            const instruction_t& instruction = code_[position];
+            int depth = depths_[position - begin_];
+            int top = depth - 1;
+
+            switch (instruction.op) {
+                case opcode_e::PUSH_INT:      emit_push(depth, integer_type,  instruction.arg); return true;
+                case opcode_e::PUSH_UNDEF:    emit_push(depth, undef_type,    0);               return true;
+                case opcode_e::PUSH_FUNCTION: emit_push(depth, function_type, instruction.arg); return true;
+                case opcode_e::POP: return true;
+
+                case opcode_e::LOAD: {
+                    copy(stack_reg, slot_at(depth), slots_reg, slot_at(instruction.arg));
+                    known_stack_[depth] = known_slots_.contains(instruction.arg);
+                    return true;
+                }
+                case opcode_e::STORE: {
+                    copy(slots_reg, slot_at(instruction.arg), stack_reg, slot_at(top));
+                    if (known_stack_[top])
+                        known_slots_.insert(instruction.arg);
+                    else
+                        known_slots_.erase(instruction.arg);
+                    return true;
+                }
+
+                case opcode_e::EQ:
+                case opcode_e::NE:
+                case opcode_e::LE:
+                case opcode_e::GE:
+                case opcode_e::LT:
+                case opcode_e::GT:
+                case opcode_e::ADD:
+                case opcode_e::SUB:
+                case opcode_e::MUL:
+                case opcode_e::DIV:
+                case opcode_e::MOD: emit_binary(instruction.op, position, depth); return true;
+
+                case opcode_e::OR_LEFT:  emit_branch(cond_e::NE, position, depth, depth); return true;
+                case opcode_e::AND_LEFT: emit_branch(cond_e::E,  position, depth, depth); return true;
+
+                case opcode_e::TO_BOOL:
+                case opcode_e::POS:
+                case opcode_e::NEG:
+                case opcode_e::NOT: emit_unary(instruction.op, position, depth); return true;
+
+                case opcode_e::JUMP: jump(x86_.jmp(), target(position), depth); return false;
+                case opcode_e::JUMP_IF_UNDEF: {
+                    if (known_stack_[top])
+                        return true;
+                    x86_.cmp32_imm8(stack_reg, type_at(top), undef_type);
+                    jump(x86_.jcc(cond_e::E), target(position), depth);
+                    return true;
+                }
+                case opcode_e::JUMP_IF_FALSE: emit_branch(cond_e::E,  position, depth, depth - 1); return true;
+                case opcode_e::JUMP_IF_TRUE:  emit_branch(cond_e::NE, position, depth, depth - 1); return true;
+
+                default: side_exit(x86_.jmp(), position, depth); return false;
+            }
+        }
+
+        int depth_after(int position) const {
+            const instruction_t& instruction = code_[position];
+            int depth = depths_[position - begin_];
+            switch (instruction.op) {
+                case opcode_e::PUSH_INT:
+                case opcode_e::PUSH_UNDEF:
+                case opcode_e::PUSH_FUNCTION:
+                case opcode_e::LOAD: return depth + 1;
+
+                case opcode_e::STORE:
+                case opcode_e::TO_BOOL:
+                case opcode_e::POS:
+                case opcode_e::NEG:
+                case opcode_e::NOT:
+                case opcode_e::JUMP_IF_UNDEF: return depth;
+
+                default: return depth - 1;
+            }
+        }
+
+        void emit_code() {
+            std::vector<bool> is_labels(end_ - begin_);
+            for (auto [position, _] : entries_)
+                is_labels[position - begin_] = true;
+            for (int position = begin_; position < end_; ++position) {
+                if (depths_[position - begin_] == unreachable || !is_jump(code_[position].op))
+                    continue;
+                if (int to = target(position); in_range(to))
+                    is_labels[to - begin_] = true;
+            }
+
+            known_stack_.assign(max_depth_, false);
+            bool is_fallthrough = false;
+            for (int position = begin_; position < end_; ++position) {
+                if (depths_[position - begin_] == unreachable) {
+                    is_fallthrough = false;
+                    continue;
+                }
+
+                if (is_labels[position - begin_] || !is_fallthrough)
+                    forget_integers();
+                labels_[position - begin_] = x86_.size();
+                is_fallthrough = emit_instruction(position);
+                if (is_fallthrough && !in_range(position + 1))
+                    side_exit(x86_.jmp(), position + 1, depth_after(position));
+            }
+
+            for (auto [rel32, position] : jumps_)
+                x86_.patch(rel32, labels_[position - begin_]);
+
+            std::vector<int> exit_labels;
+            for (int id = 0; id < static_cast<int>(exits_.size()); ++id) {
+                exit_labels.push_back(x86_.size());
+                x86_.mov_eax_imm(id);
+                x86_.ret();
+            }
+
+            for (auto [rel32, id] : exit_jumps_)
+                x86_.patch(rel32, exit_labels[id]);
+        }
+
+    public:
+        region_compiler_t(const bytecode_t& code, int begin, int end)
+        : code_(code), begin_(begin), end_(end), depths_(end - begin, unreachable), labels_(end - begin) {
+            compute_depths();
+            if (is_valid_)
+                emit_code();
+        }
+
+        bool is_valid() const noexcept { return is_valid_; }
+
+        std::unique_ptr<native_region_t> build() {
+            auto region = std::make_unique<native_region_t>();
+            region->memory = std::make_unique<native_memory_t>(x86_.code());
+            region->exits = std::move(exits_);
+            region->max_depth = max_depth_;
+
+            // entry is useless if it exits right away
+            for (auto [position, depth] : entries_) {
+                if (!is_supported(code_[position].op))
+                    continue;
+                auto native = reinterpret_cast<native_code_t>(region->memory->data() + labels_[position - begin_]);
+                region->entries.push_back({native, depth, region.get()});
+                region->entry_positions.push_back(position);
+            }
+            return region;
+        }
+    };
+
+    /* ----------------------------------------------------- */
+
+    // counts executions of loop heads and function entries, compiles them when they become hot
+    class jit_t final {
+        const bytecode_t& code_;
+        std::vector<std::unique_ptr<native_region_t>> regions_;
+        std::vector<const native_entry_t*> entries_;
+        std::vector<int> hotness_;
+        std::vector<int> function_ends_;
+
+        static constexpr int hot_threshold_ = 16;
+        static constexpr int is_compiled_   = -1;
+
+    private:
+        const native_entry_t* on_hot(int position, int end) {
+            if (const native_entry_t* entry = entries_[position])
+                return entry;
+
+            int& hotness = hotness_[position];
+            if (hotness == is_compiled_ || ++hotness < hot_threshold_)
+                return nullptr;
+
+            hotness = is_compiled_;
+            region_compiler_t compiler{code_, position, end};
+            if (!compiler.is_valid())
+                return nullptr;
+
+            native_region_t& region = *regions_.emplace_back(compiler.build());
+            for (size_t i = 0; i < region.entries.size(); ++i) {
+                const native_entry_t*& entry = entries_[region.entry_positions[i]];
+                if (!entry)
+                    entry = &region.entries[i];
+            }
+            return entries_[position];
+        }
+
+    public:
+        explicit jit_t(const bytecode_t& code)
+        : code_(code), entries_(code.size()), hotness_(code.size()), function_ends_(code.size()) {
+            // body of function is placed right after jump over it and ends right before its target
+            for (size_t i = 0; i < code_.count_functions(); ++i) {
+                int entry = code_.function(i).entry;
+                if (entry <= 0 || code_[entry - 1].op != opcode_e::JUMP)
+                    continue;
+                function_ends_[entry] = entry - 1 + code_[entry - 1].arg;
+            }
+        }
+
+        const native_entry_t* on_back_edge(int head, int back_edge) {
+            if (!is_jit_supported)
+                return nullptr;
+            return on_hot(head, back_edge + 1);
+        }
+
+        const native_entry_t* on_call(int entry) {
+            if (!is_jit_supported || function_ends_[entry] <= entry)
+                return nullptr;
+            return on_hot(entry, function_ends_[entry]);
+        }
+
+        const native_entry_t* entry(int position) const { return entries_[position]; }
+    };
+}
\ No newline at end of file
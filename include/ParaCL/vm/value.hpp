@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ParaCL/hash_table.hpp"
+#include "ParaCL/lazy_values.hpp"
+#include "ParaCL/nodes/common.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace paracl {
+    struct vm_array_t;
+    struct vm_map_t;
+
+    struct vm_value_t final {
+        node_type_e type = node_type_e::UNDEF;
+        union {
+            int         number = 0;
+            int         function;
+            vm_array_t* array;
+            vm_map_t*   map;
+        };
+    };
+
+    // slice has no values of its own, it is view over length values of base from offset,
+    // which keeps in bounds of base shrunk by pop. repeat of value, which is not array,
+    // keeps it once in lazy values until array is resized
+    struct vm_array_t final {
+        std::vector<vm_value_t> values;
+        lazy_values_t<vm_value_t> lazy;
+        bool is_lazy = false;
+        vm_array_t* base   = nullptr;
+        int         offset = 0;
+        int         length = 0;
+        bool is_marked = false;
+
+        int size() const noexcept {
+            if (base)
+                return std::clamp(base->size() - offset, 0, length);
+            return is_lazy ? lazy.size() : values.size();
+        }
+
+        // element of repeat is materialized only for write
+        vm_value_t& at(int index, bool is_write) {
+            if (base)
+                return base->at(offset + index, is_write);
+            return is_lazy ? lazy.at(index, is_write) : values[index];
+        }
+
+        const vm_value_t& operator[](int index) const {
+            if (base)
+                return (*base)[offset + index];
+            return is_lazy ? lazy.get(index) : values[index];
+        }
+
+        // push and pop need values one after another
+        void materialize() {
+            if (!is_lazy)
+                return;
+            values.reserve(lazy.size());
+            for (int i = 0; i < lazy.size(); ++i)
+                values.push_back(lazy.get(i));
+            lazy    = {};
+            is_lazy = false;
+        }
+    };
+
+    struct vm_map_t final {
+        hash_table_t<vm_value_t> values;
+        bool is_marked = false;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,705 @@
+#pragma once
+
+#include "ParaCL/node.hpp"
+#include "ParaCL/vm/bytecode.hpp"
+#include "ParaCL/vm/jit.hpp"
+#include "ParaCL/vm/value.hpp"
+
+namespace paracl {
+    class vm_t final {
+        struct frame_t final {
+            const instruction_t* return_ip;
+            size_t saved_begin;
+            int    function;
+        };
+
+        const bytecode_t& code_;
+        environments_t&   env_;
+
+        std::vector<vm_value_t> stack_;
+        std::vector<vm_value_t> slots_;
+        std::vector<vm_value_t> saved_; // frames shadowed by active calls
+        std::vector<frame_t>    frames_;
+
+        std::unique_ptr<jit_t> jit_;
+
+        std::vector<std::unique_ptr<vm_array_t>> heap_;
+        std::vector<std::unique_ptr<vm_map_t>>   maps_;
+        vm_value_t missing_; // value of key not found in map
+        size_t collect_threshold_ = min_collect_threshold_;
+        size_t count_values_      = 0; // values of arrays filled at once since last collection
+        size_t values_threshold_  = min_values_threshold_;
+
+        static constexpr size_t min_collect_threshold_ = 1024;
+        static constexpr size_t min_values_threshold_  = 1 << 20;
+
+    private:
+        [[noreturn]] void throw_error(const instruction_t* ip, const std::string& msg) const {
+            const node_loc_t* source = code_.source(ip - code_.data());
+            throw error_execute_t{source->loc(), env_.program_str, msg};
+        }
+
+        [[noreturn]] void throw_index_error(const instruction_t* ip, int depth, const std::string& msg) const {
+            auto indexes = static_cast<const node_indexes_t*>(code_.source(ip - code_.data()));
+            throw error_execute_t{indexes->get_index_loc(depth), env_.program_str, msg};
+        }
+
+        void expect_integer(const vm_value_t& value, const instruction_t* ip) const {
+            if (value.type != node_type_e::INTEGER)
+                throw_error(ip, "wrong type: " + type2str(value.type));
+        }
+
+        vm_value_t pop() {
+            vm_value_t value = stack_.back();
+            stack_.pop_back();
+            return value;
+        }
+
+        static void set_number(vm_value_t& value, int number) {
+            value.type   = node_type_e::INTEGER;
+            value.number = number;
+        }
+
+        void push_int(int number) { set_number(stack_.emplace_back(), number); }
+
+        vm_array_t* new_array() {
+            return heap_.emplace_back(std::make_unique<vm_array_t>()).get();
+        }
+
+        vm_map_t* new_map() {
+            return maps_.emplace_back(std::make_unique<vm_map_t>()).get();
+        }
+
+        // array of count integers from table of constants of bytecode
+        vm_array_t* new_constants(int first, int count) {
+            count_values_ += count;
+            vm_array_t* array = new_array();
+            array->values.resize(count);
+            const int* constants = code_.constants().data() + first;
+            for (int i : std::views::iota(0, count))
+                set_number(array->values[i], constants[i]);
+            return array;
+        }
+
+        static void mark_array(vm_array_t* array) {
+            if (array->is_marked)
+                return;
+
+            array->is_marked = true;
+            if (array->base)
+                mark_array(array->base);
+            for (const vm_value_t& elem : array->values)
+                mark(elem);
+            if (array->is_lazy)
+                array->lazy.for_each_distinct(mark);
+        }
+
+        static void mark(const vm_value_t& value) {
+            if (value.type == node_type_e::ARRAY)
+                mark_array(value.array);
+            else if (value.type == node_type_e::MAP)
+                value.map->is_marked = true; // values of map are integers
+        }
+
+        // all live arrays are reachable from stack, slots or saved frames,
+        // so collection is safe only between instructions. few big arrays are collected by count of values
+        void collect_garbage() {
+            if (heap_.size() + maps_.size() < collect_threshold_ && count_values_ < values_threshold_)
+                return;
+
+            for (const auto* roots : {&stack_, &slots_, &saved_})
+                std::ranges::for_each(*roots, mark);
+
+            std::erase_if(heap_, [](const std::unique_ptr<vm_array_t>& array) { return !array->is_marked; });
+            size_t live_values = 0;
+            std::ranges::for_each(heap_, [&live_values](auto& array) {
+                array->is_marked = false;
+                live_values += array->values.size();
+            });
+            std::erase_if(maps_, [](const std::unique_ptr<vm_map_t>& map) { return !map->is_marked; });
+            std::ranges::for_each(maps_, [](auto& map) { map->is_marked = false; });
+
+            collect_threshold_ = std::max(min_collect_threshold_, 2 * (heap_.size() + maps_.size()));
+            values_threshold_  = std::max(min_values_threshold_, live_values);
+            count_values_      = 0;
+        }
+
+        vm_value_t deep_copy(const vm_value_t& value) {
+            if (value.type != node_type_e::ARRAY)
+                return value;
+
+            vm_value_t copy = value;
+            copy.array = new_array();
+            const vm_array_t& array = *value.array;
+            if (array.is_lazy) {
+                copy.array->lazy    = array.lazy;
+                copy.array->is_lazy = true;
+                copy.array->lazy.for_each_distinct([this](vm_value_t& elem) { elem = deep_copy(elem); });
+                return copy;
+            }
+
+            copy.array->values.reserve(array.size());
+            for (int i : std::views::iota(0, array.size()))
+                copy.array->values.push_back(deep_copy(array[i]));
+            return copy;
+        }
+
+        // arrays are combined element by element and integer is combined with every element of array,
+        // as in ast engine
+        template <typename FuncT>
+        vm_value_t elementwise(const vm_value_t& lhs, const vm_value_t& rhs, FuncT& func, const instruction_t* ip) {
+            if (lhs.type == node_type_e::UNDEF || rhs.type == node_type_e::UNDEF)
+                return vm_value_t{};
+
+            if (lhs.type != node_type_e::ARRAY && rhs.type != node_type_e::ARRAY) {
+                expect_integer(lhs, ip);
+                expect_integer(rhs, ip);
+                vm_value_t result;
+                set_number(result, func(lhs.number, rhs.number));
+                return result;
+            }
+
+            const vm_array_t* l_array = lhs.type == node_type_e::ARRAY ? lhs.array : nullptr;
+            const vm_array_t* r_array = rhs.type == node_type_e::ARRAY ? rhs.array : nullptr;
+            const int size = l_array ? l_array->size() : r_array->size();
+            if (l_array && r_array && r_array->size() != size)
+                throw_error(ip,   "different sizes of arrays in operator: \"" + std::to_string(size)
+                                + "\" and \"" + std::to_string(r_array->size()) + "\"");
+
+            count_values_ += size;
+            vm_value_t result;
+            result.type  = node_type_e::ARRAY;
+            result.array = new_array();
+            std::vector<vm_value_t>& values = result.array->values;
+            values.resize(size);
+            for (int i : std::views::iota(0, size)) {
+                const vm_value_t& l_elem = l_array ? (*l_array)[i] : lhs;
+                const vm_value_t& r_elem = r_array ? (*r_array)[i] : rhs;
+                if (l_elem.type == node_type_e::INTEGER && r_elem.type == node_type_e::INTEGER) [[likely]]
+                    set_number(values[i], func(l_elem.number, r_elem.number));
+                else
+                    values[i] = elementwise(l_elem, r_elem, func, ip);
+            }
+            return result;
+        }
+
+        template <typename FuncT>
+        vm_value_t elementwise(const vm_value_t& value, FuncT& func, const instruction_t* ip) {
+            if (value.type == node_type_e::UNDEF)
+                return value;
+
+            vm_value_t result;
+            if (value.type != node_type_e::ARRAY) {
+                expect_integer(value, ip);
+                set_number(result, func(value.number));
+                return result;
+            }
+
+            const vm_array_t& array = *value.array;
+            count_values_ += array.size();
+            result.type  = node_type_e::ARRAY;
+            result.array = new_array();
+            result.array->values.reserve(array.size());
+            for (int i : std::views::iota(0, array.size()))
+                result.array->values.push_back(elementwise(array[i], func, ip));
+            return result;
+        }
+
+        // slice of slice is view over the same base
+        vm_array_t* slice(const vm_value_t& value, const vm_value_t& begin, const vm_value_t& end,
+                          const instruction_t* ip) {
+            if (value.type != node_type_e::ARRAY)
+                throw_error(ip, "wrong type: " + type2str(value.type));
+            expect_integer(begin, ip);
+            expect_integer(end, ip);
+
+            const vm_array_t& array = *value.array;
+            if (begin.number < 0 || begin.number >= end.number || end.number > array.size())
+                throw_error(ip,   "wrong bounds of slice: \"" + std::to_string(begin.number) + ':'
+                                + std::to_string(end.number) + "\", when array size: \""
+                                + std::to_string(array.size()) + "\"");
+
+            vm_array_t* view = new_array();
+            view->base   = array.base ? array.base : value.array;
+            view->offset = array.offset + begin.number;
+            view->length = end.number - begin.number;
+            return view;
+        }
+
+        // push and pop resize array in place, slice is view over fixed place of its base
+        vm_array_t& growable(const vm_value_t& value, const instruction_t* ip) const {
+            if (value.type != node_type_e::ARRAY)
+                throw_error(ip, "wrong type: " + type2str(value.type));
+            if (value.array->base)
+                throw_error(ip, "attempt to resize slice of array");
+            value.array->materialize();
+            return *value.array;
+        }
+
+        void expect_repeat_count(const vm_value_t& count, const instruction_t* ip) const {
+            expect_integer(count, ip);
+            if (count.number <= 0)
+                throw_error(ip,   "wrong input size of repeat: \"" + std::to_string(count.number) + '\"'
+                                + ", less then 0");
+        }
+
+        // repeat of value, which is not array, keeps it once as in ast engine, copies of array are made at once
+        vm_array_t* new_repeat(const vm_value_t& count, const vm_value_t& value, const instruction_t* ip) {
+            vm_array_t* array = new_array();
+            if (value.type == node_type_e::ARRAY) {
+                append_repeat(array, count, value, ip);
+                return array;
+            }
+
+            expect_repeat_count(count, ip);
+            array->lazy    = lazy_values_t<vm_value_t>{count.number, value};
+            array->is_lazy = true;
+            return array;
+        }
+
+        void append_repeat(vm_array_t* array, const vm_value_t& count, const vm_value_t& value,
+                           const instruction_t* ip) {
+            expect_repeat_count(count, ip);
+            count_values_ += count.number;
+            array->values.reserve(array->values.size() + count.number);
+            for ([[maybe_unused]] int _ : std::views::iota(0, count.number))
+                array->values.push_back(deep_copy(value));
+        }
+
+        // the first index is key of map, write inserts key, read of missing key gives 0
+        vm_value_t& shift_map(vm_map_t& map, int count, const instruction_t* ip, bool is_write) {
+            const vm_value_t& key = stack_[stack_.size() - count];
+            if (key.type != node_type_e::INTEGER)
+                throw_index_error(ip, 0, "wrong type: " + type2str(key.type));
+
+            vm_value_t* result = is_write ? &map.values[key.number] : map.values.find(key.number);
+            stack_.resize(stack_.size() - count);
+            if (result)
+                return *result;
+            set_number(missing_, 0);
+            return missing_;
+        }
+
+        // walks by count indexes from top of stack, extra indexes are ignored as in ast engine,
+        // indexes proven by analysis are not checked
+        vm_value_t& shift(vm_value_t& value, int count, const instruction_t* ip, bool is_write = false) {
+            if (value.type == node_type_e::MAP)
+                return shift_map(*value.map, count, ip, is_write);
+
+            vm_value_t* result = &value;
+            const vm_value_t* indexes = stack_.data() + stack_.size() - count;
+
+            if (result->type != node_type_e::ARRAY)
+                throw_index_error(ip, 0, "wrong type: " + type2str(result->type));
+
+            for (int depth : std::views::iota(0, count)) {
+                const vm_value_t& index = indexes[depth];
+                if (index.type != node_type_e::INTEGER)
+                    throw_index_error(ip, depth, "wrong type: " + type2str(index.type));
+
+                vm_array_t& array = *result->array;
+                if (!(ip->in_bounds >> depth & 1)) {
+                    int array_size = array.size();
+                    if (index.number < 0)
+                        throw_index_error(ip, depth,   "wrong index in array: \"" + std::to_string(index.number)
+                                                     + "\", less than 0");
+                    if (index.number >= array_size)
+                        throw_index_error(ip, depth,   "wrong index in array: \"" + std::to_string(index.number)
+                                                     + "\", when array size: \""
+                                                     + std::to_string(array_size) + "\"");
+                }
+
+                result = &array.at(index.number, is_write);
+                if (result->type != node_type_e::ARRAY)
+                    break;
+            }
+
+            stack_.resize(stack_.size() - count);
+            return *result;
+        }
+
+        void print(const vm_value_t& value, std::ostream& os) const {
+            switch (value.type) {
+                case node_type_e::INTEGER:  os << value.number; break;
+                case node_type_e::UNDEF:    os << "undef"; break;
+                case node_type_e::FUNCTION: os << "function " << code_.function(value.function).name; break;
+                case node_type_e::ARRAY: {
+                    os << '[';
+                    bool is_first = true;
+                    const vm_array_t& array = *value.array;
+                    for (int i : std::views::iota(0, array.size())) {
+                        if (!is_first)
+                            os << ", ";
+                        is_first = false;
+                        print(array[i], os);
+                    }
+                    os << ']';
+                    break;
+                }
+                case node_type_e::MAP: {
+                    os << '{';
+                    bool is_first = true;
+                    for (const auto& [key, elem] : value.map->values.sorted()) {
+                        if (!is_first)
+                            os << ", ";
+                        is_first = false;
+                        os << key << ": ";
+                        print(elem, os);
+                    }
+                    os << '}';
+                    break;
+                }
+                default: throw error_t{str_red("vm_t: print() failed: unknown type")};
+            }
+        }
+
+        template <typename FuncT>
+        void binary(FuncT&& func, const instruction_t* ip) {
+            vm_value_t  rhs = pop();
+            vm_value_t& lhs = stack_.back();
+            if (lhs.type == node_type_e::UNDEF)
+                return;
+
+            if (rhs.type == node_type_e::UNDEF) {
+                lhs.type = node_type_e::UNDEF;
+                return;
+            }
+
+            if (lhs.type == node_type_e::ARRAY || rhs.type == node_type_e::ARRAY) [[unlikely]] {
+                stack_.push_back(rhs); // operands stay roots of collection
+                collect_garbage();
+                stack_.pop_back();
+                stack_.back() = elementwise(stack_.back(), rhs, func, ip);
+                return;
+            }
+
+            expect_integer(lhs, ip);
+            expect_integer(rhs, ip);
+            lhs.number = func(lhs.number, rhs.number);
+        }
+
+        template <typename FuncT>
+        void unary(FuncT&& func, const instruction_t* ip) {
+            vm_value_t& value = stack_.back();
+            if (value.type == node_type_e::UNDEF)
+                return;
+
+            if (value.type == node_type_e::ARRAY) [[unlikely]] {
+                collect_garbage();
+                stack_.back() = elementwise(stack_.back(), func, ip);
+                return;
+            }
+
+            expect_integer(value, ip);
+            value.number = func(value.number);
+        }
+
+        bool condition(const instruction_t* ip) {
+            vm_value_t value = pop();
+            if (value.type == node_type_e::UNDEF)
+                throw_error(ip, "wrong type: undef, excpected int");
+            expect_integer(value, ip);
+            return value.number;
+        }
+
+        void call(const instruction_t*& ip) {
+            int count_args = ip->extra;
+            vm_value_t callee = stack_[stack_.size() - count_args - 1];
+            if (callee.type != node_type_e::FUNCTION)
+                throw_error(ip, "wrong type: " + type2str(callee.type));
+
+            const function_info_t& function = code_.function(callee.function);
+            if (function.count_args != count_args)
+                throw_error(ip,   "different count of declared arguments(" + std::to_string(function.count_args)
+                                + ") and count arguments for function call(" + std::to_string(count_args) + ")");
+
+            frames_.push_back({ip + 1, saved_.size(), callee.function});
+            auto frame = slots_.begin() + function.frame_begin;
+            saved_.insert(saved_.end(), frame, frame + function.count_slots);
+            for (int i : std::views::iota(0, count_args))
+                frame[i] = pop();
+            std::fill(frame + count_args, frame + function.count_slots, vm_value_t{});
+            stack_.pop_back();
+
+            ip = code_.data() + function.entry;
+        }
+
+        void ret(const instruction_t*& ip) {
+            const frame_t& frame = frames_.back();
+            const function_info_t& function = code_.function(frame.function);
+            std::ranges::copy(saved_.begin() + frame.saved_begin, saved_.end(),
+                              slots_.begin() + function.frame_begin);
+            saved_.resize(frame.saved_begin);
+            ip = frame.return_ip;
+            frames_.pop_back();
+        }
+
+        // callee returns right where finished caller would return
+        void tail_call(const instruction_t*& ip) {
+            const instruction_t* call_ip = ip;
+            ret(ip);
+            const instruction_t* return_ip = ip;
+            ip = call_ip;
+            call(ip);
+            frames_.back().return_ip = return_ip;
+        }
+
+        // hot code runs natively until instruction, which jit does not support or whose operands are not integers
+        void run_native(const instruction_t*& ip, const native_entry_t* entry) {
+            size_t base = stack_.size() - entry->depth;
+            stack_.resize(base + entry->region->max_depth);
+
+            int exit_index = entry->code(slots_.data(), stack_.data() + base);
+            const native_exit_t& exit = entry->region->exits[exit_index];
+            stack_.resize(base + exit.depth);
+            ip = code_.data() + exit.position;
+        }
+
+        // loops are closed by backward jumps, so their heads are counted by jit
+        void jump_back(const instruction_t*& ip) {
+            int back_edge = ip - code_.data();
+            ip += ip->arg;
+            if (const native_entry_t* entry = jit_->on_back_edge(ip - code_.data(), back_edge))
+                run_native(ip, entry);
+        }
+
+        void enter_function(const instruction_t*& ip) {
+            if (const native_entry_t* entry = jit_->on_call(ip - code_.data()))
+                run_native(ip, entry);
+        }
+
+        void return_to_caller(const instruction_t*& ip) {
+            if (const native_entry_t* entry = jit_->entry(ip - code_.data()))
+                run_native(ip, entry);
+        }
+
+    public:
+        vm_t(const bytecode_t& code, environments_t& env)
+        : code_(code), env_(env), slots_(code.count_slots()) {
+            assert(env_.os);
+            assert(env_.is);
+            if (env_.is_jit)
+                jit_ = std::make_unique<jit_t>(code_);
+        }
+
+        void execute() {
+            const instruction_t* ip = code_.data();
+            std::ostream& os = *env_.os;
+            std::istream& is = *env_.is;
+
+            for (;;) {
+                switch (ip->op) {
+                    case opcode_e::PUSH_INT: push_int(ip->arg); break;
+                    case opcode_e::PUSH_UNDEF: stack_.emplace_back(); break;
+                    case opcode_e::PUSH_FUNCTION: {
+                        vm_value_t& value = stack_.emplace_back();
+                        value.type     = node_type_e::FUNCTION;
+                        value.function = ip->arg;
+                        break;
+                    }
+                    case opcode_e::INPUT: {
+                        int value;
+                        is >> value;
+                        if (!is.good())
+                            throw_error(ip, "invalid input: need integer");
+                        push_int(value);
+                        break;
+                    }
+                    case opcode_e::POP: stack_.pop_back(); break;
+
+                    case opcode_e::LOAD:  stack_.push_back(slots_[ip->arg]); break;
+                    case opcode_e::STORE: slots_[ip->arg] = stack_.back(); break;
+                    case opcode_e::LOAD_INDEXED: {
+                        vm_value_t value = shift(slots_[ip->arg], ip->extra, ip);
+                        stack_.push_back(value);
+                        break;
+                    }
+                    case opcode_e::STORE_INDEXED: {
+                        vm_value_t& elem = shift(slots_[ip->arg], ip->extra, ip, true);
+                        elem = stack_.back();
+                        break;
+                    }
+                    case opcode_e::INDEX: {
+                        vm_value_t array = stack_[stack_.size() - ip->extra - 1];
+                        vm_value_t value = shift(array, ip->extra, ip);
+                        stack_.back() = value;
+                        break;
+                    }
+
+                    case opcode_e::NEW_ARRAY: {
+                        collect_garbage();
+                        vm_value_t& value = stack_.emplace_back();
+                        value.type  = node_type_e::ARRAY;
+                        value.array = new_array();
+                        break;
+                    }
+                    case opcode_e::NEW_MAP: {
+                        collect_garbage();
+                        vm_value_t& value = stack_.emplace_back();
+                        value.type = node_type_e::MAP;
+                        value.map  = new_map();
+                        break;
+                    }
+                    case opcode_e::NEW_REPEAT: {
+                        collect_garbage();
+                        vm_value_t init  = pop();
+                        vm_value_t count = pop();
+                        vm_value_t& value = stack_.emplace_back();
+                        value.type  = node_type_e::ARRAY;
+                        value.array = new_repeat(count, init, ip);
+                        break;
+                    }
+                    case opcode_e::NEW_CONSTANTS: {
+                        collect_garbage();
+                        vm_value_t& value = stack_.emplace_back();
+                        value.type  = node_type_e::ARRAY;
+                        value.array = new_constants(ip->arg, ip->extra);
+                        break;
+                    }
+                    case opcode_e::ARRAY_APPEND: {
+                        vm_value_t value = pop();
+                        stack_.back().array->values.push_back(value);
+                        break;
+                    }
+                    case opcode_e::ARRAY_APPEND_REPEAT: {
+                        collect_garbage();
+                        vm_value_t init  = pop();
+                        vm_value_t count = pop();
+                        append_repeat(stack_.back().array, count, init, ip);
+                        break;
+                    }
+                    case opcode_e::SLICE: {
+                        collect_garbage();
+                        vm_value_t end   = pop();
+                        vm_value_t begin = pop();
+                        vm_value_t& value = stack_.back();
+                        value.array = slice(value, begin, end, ip);
+                        break;
+                    }
+                    case opcode_e::ARRAY_PUSH: {
+                        vm_value_t value = pop();
+                        std::vector<vm_value_t>& values = growable(stack_.back(), ip).values;
+                        values.push_back(value);
+                        set_number(stack_.back(), values.size());
+                        break;
+                    }
+                    case opcode_e::ARRAY_POP: {
+                        std::vector<vm_value_t>& values = growable(stack_.back(), ip).values;
+                        if (values.empty())
+                            throw_error(ip, "attempt to pop from empty array");
+                        stack_.back() = values.back();
+                        values.pop_back();
+                        break;
+                    }
+                    case opcode_e::ARRAY_LEN: {
+                        vm_value_t& value = stack_.back();
+                        if (value.type == node_type_e::MAP) {
+                            set_number(value, value.map->values.size());
+                            break;
+                        }
+                        if (value.type != node_type_e::ARRAY)
+                            throw_error(ip, "wrong type: " + type2str(value.type));
+                        set_number(value, value.array->size());
+                        break;
+                    }
+
+                    case opcode_e::EQ:  binary([](int lhs, int rhs) { return lhs == rhs; }, ip); break;
+                    case opcode_e::NE:  binary([](int lhs, int rhs) { return lhs != rhs; }, ip); break;
+                    case opcode_e::LE:  binary([](int lhs, int rhs) { return lhs <= rhs; }, ip); break;
+                    case opcode_e::GE:  binary([](int lhs, int rhs) { return lhs >= rhs; }, ip); break;
+                    case opcode_e::LT:  binary([](int lhs, int rhs) { return lhs <  rhs; }, ip); break;
+                    case opcode_e::GT:  binary([](int lhs, int rhs) { return lhs >  rhs; }, ip); break;
+                    case opcode_e::ADD: binary([](int lhs, int rhs) { return lhs +  rhs; }, ip); break;
+                    case opcode_e::SUB: binary([](int lhs, int rhs) { return lhs -  rhs; }, ip); break;
+                    case opcode_e::MUL: binary([](int lhs, int rhs) { return lhs *  rhs; }, ip); break;
+                    case opcode_e::DIV: binary([](int lhs, int rhs) { return lhs /  rhs; }, ip); break;
+                    case opcode_e::MOD: binary([](int lhs, int rhs) { return lhs %  rhs; }, ip); break;
+
+                    case opcode_e::OR_LEFT:
+                    case opcode_e::AND_LEFT: {
+                        const vm_value_t& lhs = stack_.back();
+                        if (lhs.type == node_type_e::UNDEF) {
+                            ip += ip->arg;
+                            continue;
+                        }
+                        expect_integer(lhs, ip);
+                        if ((lhs.number != 0) == (ip->op == opcode_e::OR_LEFT)) {
+                            ip += ip->arg;
+                            continue;
+                        }
+                        stack_.pop_back();
+                        break;
+                    }
+                    case opcode_e::TO_BOOL: {
+                        vm_value_t& value = stack_.back();
+                        if (value.type == node_type_e::UNDEF)
+                            break;
+                        expect_integer(value, ip);
+                        value.number = (value.number != 0);
+                        break;
+                    }
+
+                    case opcode_e::POS: unary([](int value) { return  value; }, ip); break;
+                    case opcode_e::NEG: unary([](int value) { return -value; }, ip); break;
+                    case opcode_e::NOT: unary([](int value) { return !value; }, ip); break;
+
+                    case opcode_e::PRINT: {
+                        print(stack_.back(), os);
+                        os << '\n';
+                        break;
+                    }
+
+                    case opcode_e::JUMP: ip += ip->arg; continue;
+                    case opcode_e::JUMP_IF_UNDEF: {
+                        if (stack_.back().type == node_type_e::UNDEF) {
+                            ip += ip->arg;
+                            continue;
+                        }
+                        break;
+                    }
+                    case opcode_e::JUMP_IF_FALSE: {
+                        if (!condition(ip)) {
+                            ip += ip->arg;
+                            continue;
+                        }
+                        break;
+                    }
+                    case opcode_e::JUMP_IF_TRUE: {
+                        if (condition(ip)) {
+                            if (jit_ && ip->arg < 0)
+                                jump_back(ip);
+                            else
+                                ip += ip->arg;
+                            continue;
+                        }
+                        break;
+                    }
+
+                    case opcode_e::CALL:
+                    case opcode_e::TAIL_CALL: {
+                        if (ip->op == opcode_e::CALL)
+                            call(ip);
+                        else
+                            tail_call(ip);
+
+                        if (jit_)
+                            enter_function(ip);
+                        continue;
+                    }
+                    case opcode_e::RET: {
+                        ret(ip);
+                        if (jit_)
+                            return_to_caller(ip);
+                        continue;
+                    }
+
+                    case opcode_e::MISSING_RETURN: throw_error(ip, "missing return value");
+                    case opcode_e::HALT: return;
+
+                    default: throw error_t{str_red("vm_t: execute() failed: unknown opcode")};
+                }
+                ++ip;
+            }
+        }
+    };
+}
\ No newline at end of file
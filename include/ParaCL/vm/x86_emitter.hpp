@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace paracl {
+    // encodes the few x86-64 instructions used by jit templates,
+    // memory operands are always [base + disp32]. fields of values are written by whole qwords,
+    // so following loads of them are forwarded from store buffer
+    class x86_emitter_t final {
+    public:
+        enum class reg_e : uint8_t { RAX = 0, RCX = 1, RDX = 2, RSI = 6, RDI = 7 };
+        enum class cond_e : uint8_t { E = 0x4, NE = 0x5, L = 0xC, GE = 0xD, LE = 0xE, G = 0xF };
+
+        // alu instructions in form "op eax, dword [mem]"
+        enum class alu_e : uint8_t { ADD = 0x03, SUB = 0x2B, CMP = 0x3B };
+
+    private:
+        static constexpr uint8_t rex_w = 0x48;
+
+        std::vector<uint8_t> code_;
+
+    private:
+        void bytes(std::initializer_list<uint8_t> values) { code_.insert(code_.end(), values); }
+
+        void imm32(int32_t value) {
+            uint8_t bytes[4];
+            std::memcpy(bytes, &value, 4);
+            code_.insert(code_.end(), bytes, bytes + 4);
+        }
+
+        void mem(uint8_t reg, reg_e base, int32_t disp) {
+            code_.push_back(0x80 | (reg << 3) | static_cast<uint8_t>(base));
+            imm32(disp);
+        }
+
+        static uint8_t id(reg_e reg) noexcept { return static_cast<uint8_t>(reg); }
+
+    public:
+        int size() const noexcept { return code_.size(); }
+        const std::vector<uint8_t>& code() const noexcept { return code_; }
+
+        // mov reg32, dword [base + disp], upper half of register is cleared
+        void load32(reg_e reg, reg_e base, int32_t disp) { bytes({0x8B}); mem(id(reg), base, disp); }
+
+        // mov reg, qword [base + disp]
+        void load64(reg_e reg, reg_e base, int32_t disp) { bytes({rex_w, 0x8B}); mem(id(reg), base, disp); }
+
+        // mov qword [base + disp], reg
+        void store64(reg_e base, int32_t disp, reg_e reg) { bytes({rex_w, 0x89}); mem(id(reg), base, disp); }
+
+        // mov qword [base + disp], sign extended imm
+        void store_imm64(reg_e base, int32_t disp, int32_t imm) { bytes({rex_w, 0xC7}); mem(0, base, disp); imm32(imm); }
+
+        // op eax, dword [base + disp]
+        void alu32(alu_e op, reg_e base, int32_t disp) { bytes({static_cast<uint8_t>(op)}); mem(0, base, disp); }
+
+        // imul eax, dword [base + disp]
+        void imul32(reg_e base, int32_t disp) { bytes({0x0F, 0xAF}); mem(0, base, disp); }
+
+        // cdq; idiv dword [base + disp], quotient in eax, remainder in edx
+        void idiv32(reg_e base, int32_t disp) { bytes({0x99, 0xF7}); mem(7, base, disp); }
+
+        // cmp dword [base + disp], imm8
+        void cmp32_imm8(reg_e base, int32_t disp, int8_t imm) {
+            bytes({0x83});
+            mem(7, base, disp);
+            code_.push_back(static_cast<uint8_t>(imm));
+        }
+
+        // neg eax
+        void neg_eax() { bytes({0xF7, 0xD8}); }
+
+        // test eax, eax; setcc al; movzx eax, al
+        void test_set_eax(cond_e cond) {
+            bytes({0x85, 0xC0});
+            set_eax(cond);
+        }
+
+        // setcc al; movzx eax, al
+        void set_eax(cond_e cond) {
+            bytes({0x0F, static_cast<uint8_t>(0x90 | static_cast<uint8_t>(cond)), 0xC0});
+            bytes({0x0F, 0xB6, 0xC0});
+        }
+
+        void mov_eax_imm(int32_t imm) { bytes({0xB8}); imm32(imm); }
+        void ret() { bytes({0xC3}); }
+
+        // jumps return position of rel32 to patch it when target is known
+        int jmp() { bytes({0xE9}); imm32(0); return size() - 4; }
+        int jcc(cond_e cond) {
+            bytes({0x0F, static_cast<uint8_t>(0x80 | static_cast<uint8_t>(cond))});
+            imm32(0);
+            return size() - 4;
+        }
+
+        void patch(int rel32, int target) {
+            int32_t offset = target - (rel32 + 4);
+            std::memcpy(code_.data() + rel32, &offset, 4);
+        }
+    };
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "ParaCL/ast.hpp"
+#include "ParaCL/vm/c_compiler.hpp"
 #include "ParaCL/driver.hpp"
 #include "ParaCL/cmd.hpp"
 
@@ -12,11 +13,16 @@ int main(int argc, char* argv[]) try {
     paracl::ast_t ast;
     driver.parse(cmd_data.program_file(), ast.buffer_, ast.root_, program_str);
 
-    paracl::environments_t env{&(std::cout), &(std::cin), program_str};
+    paracl::environments_t env{&(std::cout), &(std::cin), program_str, cmd_data.engine(), cmd_data.is_jit()};
     ast.analyze(env);
 
-    if (!cmd_data.is_analyze_only())
+    if (cmd_data.is_emit_c()) {
+        ast.emit_c(env, cmd_data.emit_c_file());
+        if (cmd_data.is_compile())
+            paracl::compile_c(cmd_data.emit_c_file());
+    } else if (!cmd_data.is_analyze_only()) {
         ast.execute(env);
+    }
 
 } catch (const paracl::error_t& error) {
     std::cout << error.what() << '\n';
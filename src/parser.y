@@ -43,7 +43,7 @@ Grammar:
     expression_cmp -> expression_cmp bin_oper_cmp expression_pls | expression_pls
     expression_pls -> expression_pls bin_oper_pls expression_mul | expression_mul
     expression_mul -> expression_mul bin_oper_mul terminal       | terminal
-    terminal       -> ( expression ) | number | undef | array | ? |
+    terminal       -> ( expression ) | number | undef | array | slice | array_builtin | map | ? |
                                        un_oper terminal | variable_shifted | function_call
     variable         -> id
     variable_shifted -> variable indexes
@@ -55,6 +55,10 @@ Grammar:
     array_value    -> expression_single | repeat_values
     indexes        -> indexes index | empty
     index          -> [ expression ]
+    slice          -> slice ( expression_single, expression_single, expression_single ) indexes
+    array_builtin  -> push ( expression_single, expression_single ) | pop ( expression_single ) |
+                      len ( expression_single )
+    map            -> map ( )
 */
 
 %language "c++"
@@ -100,6 +104,11 @@ Grammar:
     COMMA
     ARRAY
     REPEAT
+    SLICE
+    PUSH
+    POP
+    LEN
+    MAP
 
     LBRACKET_ROUND
     RBRACKET_ROUND
@@ -192,6 +201,9 @@ Grammar:
 %nterm <node_array_value_t*>   array_value
 %nterm <node_indexes_t*>       indexes
 %nterm <node_expression_t*>    index
+%nterm <node_slice_t*>         slice
+%nterm <node_array_builtin_t*> array_builtin
+%nterm <node_map_t*>           map
 
 %nterm <node_expression_t*> expression_lgc
 %nterm <node_expression_t*> expression_cmp
@@ -213,6 +225,7 @@ Grammar:
 
     std::stack<scope_base_t*> scopes_stack;
     scope_base_t* current_scope = nullptr;
+    std::stack<node_function_t*> functions_stack; // functions, which bodies are parsed now
 
     /* ----------------------------------------------- */
 
@@ -235,8 +248,12 @@ Grammar:
 
         node_variable_t* var = static_cast<node_variable_t*>(current_scope->get_node(name));
         if (!var) {
-            var = driver->add_node<node_variable_t>(loc, name.length(), name);
+            var = driver->add_node<node_variable_t>(loc, name.length(), driver->intern(name));
             current_scope->add_variable(var);
+            if (!functions_stack.empty()) {
+                frame_info_t& frame = functions_stack.top()->frame();
+                var->bind_slot(&frame, frame.add_slot());
+            }
         }
         return var;
     }
@@ -293,6 +310,7 @@ function: function_decl function_body
                 $$ = $1;
                 $$->bind_body($2);
                 func_args = {};
+                functions_stack.pop();
             }
 ;
 
@@ -304,8 +322,10 @@ function_decl: FUNC LBRACKET_ROUND function_args RBRACKET_ROUND function_name
                     throw error_declaration_t{function_loc, program_str,
                                               "this name already declared in global scope"};}
 
-                $$ = driver->add_node<node_function_t>(@1, 4, $3, nullptr, function_name);
+                $$ = driver->add_node<node_function_t>(@1, 4, $3, nullptr,
+                        driver->intern(function_name.empty() ? node_function_t::default_name() : $5.first));
                 global_scope_names.add_variable($$);
+                functions_stack.push($$);
             }
 ;
 
@@ -343,14 +363,14 @@ function_args_empty: %empty { $$ = driver->add_node<node_function_args_t>(@$, 1)
 function_args_filled: function_args COMMA variable
                         {
                             $$ = $1;
-                            node_variable_t* var = driver->add_node<node_variable_t>(@3, $3.length(), $3);
+                            node_variable_t* var = driver->add_node<node_variable_t>(@3, $3.length(), driver->intern($3));
                             $$->add_arg(var);
                             func_args.push_back(var);
                         }
                     | variable
                         {
                             $$ = driver->add_node<node_function_args_t>(@$, 1);
-                            node_variable_t* var = driver->add_node<node_variable_t>(@1, $1.length(), $1);
+                            node_variable_t* var = driver->add_node<node_variable_t>(@1, $1.length(), driver->intern($1));
                             $$->add_arg(var);
                             func_args.push_back(var);
                         }
@@ -471,6 +491,9 @@ terminal: LBRACKET_ROUND expression RBRACKET_ROUND { $$ = $2; }
         | UNDEF             { $$ = driver->add_node<node_undef_t>(@1, 5); }
         | INPUT             { $$ = driver->add_node<node_input_t>(@1, 1); }
         | array             { $$ = $1; }
+        | slice             { $$ = $1; }
+        | array_builtin     { $$ = $1; }
+        | map               { $$ = $1; }
         | un_oper terminal  { $$ = driver->add_node<node_un_op_t>(@1, 1, $1, $2); }
         | variable_shifted  { $$ = $1; }
         | function_call     { $$ = $1; }
@@ -519,6 +542,21 @@ indexes: %empty        { $$ = driver->add_node<node_indexes_t>(@$, 1); }
 index: LBRACKET_SQUARE expression RBRACKET_SQUARE { $$ = $2; }
 ;
 
+slice: SLICE LBRACKET_ROUND expression_single COMMA expression_single COMMA expression_single RBRACKET_ROUND indexes
+        { $$ = driver->add_node<node_slice_t>(@1, 5, $3, $5, $7, $9); }
+;
+
+array_builtin: PUSH LBRACKET_ROUND expression_single COMMA expression_single RBRACKET_ROUND
+                { $$ = driver->add_node<node_array_builtin_t>(@1, 4, array_builtins_e::PUSH, $3, $5); }
+             | POP LBRACKET_ROUND expression_single RBRACKET_ROUND
+                { $$ = driver->add_node<node_array_builtin_t>(@1, 3, array_builtins_e::POP, $3); }
+             | LEN LBRACKET_ROUND expression_single RBRACKET_ROUND
+                { $$ = driver->add_node<node_array_builtin_t>(@1, 3, array_builtins_e::LEN, $3); }
+;
+
+map: MAP LBRACKET_ROUND RBRACKET_ROUND { $$ = driver->add_node<node_map_t>(@1, 3); }
+;
+
 bin_oper_lgc: OR   { $$ = binary_operators_e::OR; }
             | AND  { $$ = binary_operators_e::AND; }
 ;
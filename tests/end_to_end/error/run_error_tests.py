@@ -1,4 +1,5 @@
 import os
+import sys
 import glob
 import subprocess
 from pathlib import Path
@@ -14,13 +15,33 @@ is_OK = True
 
 def run(program, input, exe_file):
     global is_OK
-    with open(input, 'r') as infile:
-        result = subprocess.run([exe_file, program], stdin=infile, capture_output=True)
+    if engine == "c":
+        result = run_c(program, input, exe_file)
+    else:
+        with open(input, 'r') as infile:
+            result = subprocess.run([exe_file, program] + engine_flags, stdin=infile, capture_output=True)
     if result.returncode == 0:
         print(bcolors.FAIL + "result is valid: " + program + bcolors.ENDC)
         is_OK = False
     return result.returncode
 
+# error is found either by translator or by compiled program
+def run_c(program, input, exe_file):
+    c_dir = proj_dir + "/c_programs"
+    os.system("mkdir -p " + c_dir)
+    c_file = c_dir + "/" + Path(program).stem + ".cpp"
+    result = subprocess.run([exe_file, program, "--emit-c", c_file, "--compile"], capture_output=True)
+    if result.returncode != 0:
+        return result
+
+    with open(input, 'r') as infile:
+        return subprocess.run([c_dir + "/" + Path(program).stem], stdin=infile, capture_output=True)
+
+engine = sys.argv[1] if len(sys.argv) > 1 else "ast"
+engine_flags = ["--engine=" + engine] if engine != "ast" else []
+if engine == "jit":
+    engine_flags = ["--engine=vm", "--jit"]
+
 paracl_exe = proj_dir + "/../../src/paracl"
 program_files = list(map(str, glob.glob(tests_dir + "/tests_in/test_*.in")))
 program_files.sort()
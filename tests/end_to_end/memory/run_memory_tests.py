@@ -0,0 +1,62 @@
+import os
+import sys
+import glob
+import subprocess
+from pathlib import Path
+
+class bcolors:
+    INFO = "\033[93m"
+    FAIL = '\033[31m'
+    ENDC = '\033[0m'
+
+tests_dir = str(Path(__file__).parent)
+proj_dir  = str(Path.cwd())
+is_OK = True
+
+# every program reads count of iterations of its steady-state loop,
+# peak memory must not depend on it
+small_count      = 10000
+large_count      = 100000
+max_growth_kb    = 1024
+max_growth_ratio = 0.05 # shadow memory and metadata of sanitizers grow a bit with runtime
+
+# quarantine of address sanitizer keeps freed memory, so reclaimed values would look as leak
+sanitizer_env = dict(os.environ)
+sanitizer_env["ASAN_OPTIONS"] = ":".join(filter(None, [os.environ.get("ASAN_OPTIONS"),
+                                                        "quarantine_size_mb=0"]))
+
+def peak_rss(program, count, exe_file):
+    global is_OK
+    process = subprocess.Popen([exe_file, program] + engine_flags,
+                               stdin=subprocess.PIPE, stdout=subprocess.DEVNULL, env=sanitizer_env)
+    process.stdin.write((str(count) + "\n").encode("utf-8"))
+    process.stdin.close()
+    _, status, usage = os.wait4(process.pid, 0)
+    if os.waitstatus_to_exitcode(status) != 0:
+        print(bcolors.FAIL + "execution failed: " + program + bcolors.ENDC)
+        is_OK = False
+    return usage.ru_maxrss
+
+def run(program, exe_file):
+    global is_OK
+    small_rss = peak_rss(program, small_count, exe_file)
+    large_rss = peak_rss(program, large_count, exe_file)
+    if large_rss - small_rss > max_growth_kb + max_growth_ratio * small_rss:
+        print(bcolors.FAIL + "memory grows with iterations: " + program + ": "
+              + str(small_rss) + " KB -> " + str(large_rss) + " KB" + bcolors.ENDC)
+        is_OK = False
+
+engine = sys.argv[1] if len(sys.argv) > 1 else "ast"
+engine_flags = ["--engine=" + engine] if engine != "ast" else []
+if engine == "jit":
+    engine_flags = ["--engine=vm", "--jit"]
+
+paracl_exe = proj_dir + "/../../src/paracl"
+program_files = list(map(str, glob.glob(tests_dir + "/tests_in/test_*.in")))
+program_files.sort()
+
+for program in program_files:
+    run(program, paracl_exe)
+
+if not(is_OK):
+    exit(1)
\ No newline at end of file
@@ -1,4 +1,5 @@
 import os
+import sys
 import glob
 import subprocess
 from pathlib import Path
@@ -12,12 +13,28 @@ def run(program, input, answer_dir, exe_file):
     os.system("touch " + file_name)
     os.system("echo -n > " + file_name)
     ans_file = open(file_name, 'w')
-    command = exe_file + " " + program + " < " + input
+    if engine == "c":
+        command = emit_c(program, exe_file) + " < " + input
+    else:
+        command = exe_file + " " + program + engine_flag + " < " + input
     ans_file.write(subprocess.check_output(command, shell=True).decode("utf-8"))
     ans_file.close()
 
+# translates program to c++ and compiles it, returns compiled program
+def emit_c(program, exe_file):
+    c_dir = build_dir + "/c_programs"
+    os.system("mkdir -p " + c_dir)
+    c_file = c_dir + "/" + Path(program).stem + ".cpp"
+    subprocess.check_call([exe_file, program, "--emit-c", c_file, "--compile"])
+    return c_dir + "/" + Path(program).stem
+
+engine = sys.argv[1] if len(sys.argv) > 1 else "ast"
+engine_flag = " --engine=" + engine if engine != "ast" else ""
+if engine == "jit":
+    engine_flag = " --engine=vm --jit"
+
 paracl_exe = build_dir + "/../../src/paracl"
-paracl_answers_dir =  tests_dir + "/answers_get"
+paracl_answers_dir =  tests_dir + "/answers_get" + ("_" + engine if engine != "ast" else "")
 
 program_files = list(map(str, glob.glob(tests_dir + "/tests_in/test_*.in")))
 program_files.sort()
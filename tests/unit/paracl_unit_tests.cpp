@@ -1,10 +1,74 @@
 #include <gtest/gtest.h>
 
-#include <fstream>
+#include "ParaCL/ast.hpp"
+
 #include <vector>
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+namespace {
+    size_t count_allocations = 0;
+
+    void* counted_allocate(size_t size, size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        ++count_allocations;
+        if (size == 0)
+            size = 1;
+
+        void* ptr = nullptr;
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ptr = std::malloc(size);
+        else // aligned_alloc requires size to be multiple of alignment
+            ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+
+        if (ptr)
+            return ptr;
+        throw std::bad_alloc{};
+    }
+
+    // not inlined into operator delete, otherwise compiler pairs free with operator new at call sites
+    [[gnu::noinline]] void counted_deallocate(void* ptr) noexcept { std::free(ptr); }
+
+    template <typename... ArgsT>
+    void* counted_allocate_nothrow(ArgsT... args) noexcept {
+        try {
+            return counted_allocate(args...);
+        } catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+    }
+}
+
+// whole set of replaceable forms, so every allocation is counted and freed by its pair
+void* operator new  (size_t size) { return counted_allocate(size); }
+void* operator new[](size_t size) { return counted_allocate(size); }
+void* operator new  (size_t size, std::align_val_t al) { return counted_allocate(size, size_t(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return counted_allocate(size, size_t(al)); }
+
+void* operator new  (size_t size, const std::nothrow_t&) noexcept { return counted_allocate_nothrow(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted_allocate_nothrow(size); }
+void* operator new  (size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_allocate_nothrow(size, size_t(al));
+}
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_allocate_nothrow(size, size_t(al));
+}
+
+void operator delete  (void* ptr) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { counted_deallocate(ptr); }
+void operator delete  (void* ptr, size_t) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { counted_deallocate(ptr); }
+void operator delete  (void* ptr, std::align_val_t) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { counted_deallocate(ptr); }
+void operator delete  (void* ptr, size_t, std::align_val_t) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { counted_deallocate(ptr); }
+void operator delete  (void* ptr, const std::nothrow_t&) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { counted_deallocate(ptr); }
+void operator delete  (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { counted_deallocate(ptr); }
 
 std::vector<std::string> get_sorted_files(std::filesystem::path path) {
     std::vector<std::string> files;
@@ -16,12 +80,12 @@ std::vector<std::string> get_sorted_files(std::filesystem::path path) {
     return files;
 }
 
-TEST(Paracl_shuffle, end_to_end) {
+void compare_answers(std::string_view answers_get_dir) {
     std::string file{__FILE__};
     std::filesystem::path dir = file.substr(0, file.rfind('/'));
     std::filesystem::path tests_dir = dir / "../end_to_end/valid";
 
-    std::filesystem::path answers_get_path = tests_dir / "answers_get";
+    std::filesystem::path answers_get_path = tests_dir / answers_get_dir;
     std::filesystem::path answers_src_path = tests_dir / "answers_src";
 
     std::vector<std::string> answers_get_str = get_sorted_files(answers_get_path);
@@ -48,6 +112,221 @@ TEST(Paracl_shuffle, end_to_end) {
     }
 }
 
+TEST(Paracl_shuffle, end_to_end) {
+    compare_answers("answers_get");
+}
+
+TEST(Paracl_shuffle, end_to_end_vm) {
+    compare_answers("answers_get_vm");
+}
+
+TEST(Paracl_shuffle, end_to_end_c) {
+    compare_answers("answers_get_c");
+}
+
+TEST(Paracl_shuffle, end_to_end_jit) {
+    compare_answers("answers_get_jit");
+}
+
+using namespace paracl;
+
+// s = 0; i = 0; while (i < count) { s = s + { i * 2; } + step; i = i + 1; },
+// where step is 0, call of recursive function or element of array of arrays
+enum class step_e {
+    ZERO,
+    CALLS,
+    ARRAY
+};
+
+class loop_program_t final {
+    buffer_t   buf_;
+    location_t loc_;
+
+    node_scope_t* root_;
+
+private:
+    node_lvalue_t* lvalue(node_variable_t* variable) {
+        return buf_.add_node<node_lvalue_t>(loc_, variable, buf_.add_node<node_indexes_t>(loc_));
+    }
+
+    node_number_t* number(int value) { return buf_.add_node<node_number_t>(loc_, value); }
+
+    node_bin_op_t* bin_op(binary_operators_e type, node_expression_t* left, node_expression_t* right) {
+        return buf_.add_node<node_bin_op_t>(loc_, type, left, right);
+    }
+
+    node_instruction_t* assign(node_variable_t* variable, node_expression_t* value) {
+        return buf_.add_node<node_instruction_t>(
+            loc_, buf_.add_node<node_assign_t>(loc_, lvalue(variable), value)
+        );
+    }
+
+    template <typename... ArgsT>
+    node_function_call_t* call(node_function_t* function, ArgsT... args) {
+        auto* call_args = buf_.add_node<node_function_call_args_t>(loc_);
+        (call_args->add_arg(args), ...);
+        return buf_.add_node<node_function_call_wrapper_t>(loc_, function, call_args, true);
+    }
+
+    // func(x, k) { if (k == 0) return x; return f(x + 1, k - 1); } or with f(x, k - 1) + 1,
+    // which is not tail call
+    node_function_t* recursive_function(bool is_tail) {
+        auto* args = buf_.add_node<node_function_args_t>(loc_);
+        auto* x = buf_.add_node<node_variable_t>(loc_, "x");
+        auto* k = buf_.add_node<node_variable_t>(loc_, "k");
+        args->add_arg(x);
+        args->add_arg(k);
+
+        auto* function = buf_.add_node<node_function_t>(loc_, args, nullptr, "");
+        auto* body = buf_.add_node<node_scope_return_t>(loc_, root_);
+
+        auto* base = buf_.add_node<node_scope_t>(loc_, body);
+        base->set_return(lvalue(x));
+        auto* condition = bin_op(binary_operators_e::EQ, lvalue(k), number(0));
+        body->push_statement(buf_.add_node<node_fork_t>(loc_, condition, base,
+                                                        buf_.add_node<node_scope_t>(loc_, body)));
+
+        auto* k_next = bin_op(binary_operators_e::SUB, lvalue(k), number(1));
+        if (is_tail)
+            body->set_return(call(function, bin_op(binary_operators_e::ADD, lvalue(x), number(1)), k_next));
+        else
+            body->set_return(bin_op(binary_operators_e::ADD, call(function, lvalue(x), k_next), number(1)));
+
+        function->bind_body(body);
+        return function;
+    }
+
+    // repeat(array(repeat(1, 3)), 3)[1][2]
+    node_lvalue_t* array_element() {
+        auto* row_value = buf_.add_node<node_list_values_t>(loc_);
+        row_value->add_value(buf_.add_node<node_repeat_values_t>(loc_, number(1), number(3)));
+        auto* rows = buf_.add_node<node_array_t>(
+            loc_, buf_.add_node<node_repeat_values_t>(loc_, buf_.add_node<node_array_t>(
+                loc_, row_value, buf_.add_node<node_indexes_t>(loc_)
+            ), number(3)), buf_.add_node<node_indexes_t>(loc_)
+        );
+
+        auto* a = buf_.add_node<node_variable_t>(loc_, "a");
+        root_->push_statement(assign(a, rows));
+
+        auto* indexes = buf_.add_node<node_indexes_t>(loc_);
+        indexes->add_index(number(1));
+        indexes->add_index(number(2));
+        return buf_.add_node<node_lvalue_t>(loc_, a, indexes);
+    }
+
+public:
+    // loop is nested in scopes, so statements of its iteration are on different depths of stack
+    loop_program_t(int count, int depth, step_e step_type = step_e::ZERO) {
+        root_ = buf_.add_node<node_scope_t>(loc_, nullptr);
+        auto* s = buf_.add_node<node_variable_t>(loc_, "s");
+        auto* i = buf_.add_node<node_variable_t>(loc_, "i");
+        root_->push_statement(assign(s, number(0)));
+        root_->push_statement(assign(i, number(0)));
+
+        auto* body    = buf_.add_node<node_scope_t>(loc_, root_);
+        auto* scope_r = buf_.add_node<node_scope_return_t>(loc_, body);
+        scope_r->set_return(bin_op(binary_operators_e::MUL, lvalue(i), number(2)));
+
+        node_expression_t* step = number(0);
+        if (step_type == step_e::CALLS)
+            step = bin_op(binary_operators_e::ADD, call(recursive_function(true),  lvalue(i), number(10)),
+                                                   call(recursive_function(false), lvalue(i), number(10)));
+        else if (step_type == step_e::ARRAY)
+            step = array_element();
+
+        auto* sum = bin_op(binary_operators_e::ADD, lvalue(s), scope_r);
+        body->push_statement(assign(s, bin_op(binary_operators_e::ADD, sum, step)));
+        body->push_statement(assign(i, bin_op(binary_operators_e::ADD, lvalue(i), number(1))));
+
+        node_statement_t* statement =
+            buf_.add_node<node_loop_t>(loc_, bin_op(binary_operators_e::LT, lvalue(i), number(count)), body);
+        for (int j = 0; j < depth; ++j) {
+            auto* scope = buf_.add_node<node_scope_t>(loc_, root_);
+            scope->push_statement(statement);
+            statement = scope;
+        }
+        root_->push_statement(statement);
+    }
+
+    size_t execute(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        std::ostringstream os;
+        std::istringstream is;
+        buffer_t execution_buffer{resource};
+        execute_params_t params{&execution_buffer, &os, &is, "", resource};
+
+        size_t old_count_allocations = count_allocations;
+        execute_ast(root_, params);
+        return count_allocations - old_count_allocations;
+    }
+};
+
+TEST(Paracl_allocations, loop_iteration) {
+    for (int depth = 0; depth < 100; ++depth) {
+        size_t short_loop = loop_program_t{10,   depth}.execute();
+        size_t long_loop  = loop_program_t{1000, depth}.execute();
+        EXPECT_EQ(short_loop, long_loop) << "depth: " << depth;
+    }
+}
+
+TEST(Paracl_allocations, function_call) {
+    for (int depth = 0; depth < 10; ++depth) {
+        size_t short_loop = loop_program_t{10,   depth, step_e::CALLS}.execute();
+        size_t long_loop  = loop_program_t{1000, depth, step_e::CALLS}.execute();
+        EXPECT_EQ(short_loop, long_loop) << "depth: " << depth;
+    }
+}
+
+// access by indexes evaluates them without vectors
+TEST(Paracl_allocations, array_access) {
+    for (int depth = 0; depth < 10; ++depth) {
+        size_t short_loop = loop_program_t{10,   depth, step_e::ARRAY}.execute();
+        size_t long_loop  = loop_program_t{1000, depth, step_e::ARRAY}.execute();
+        EXPECT_EQ(short_loop, long_loop) << "depth: " << depth;
+    }
+}
+
+// all memory of run comes from resource, so it is dropped at once
+TEST(Paracl_allocations, memory_resource) {
+    static std::byte memory[1 << 20];
+    for (int depth = 0; depth < 10; ++depth) {
+        std::pmr::monotonic_buffer_resource resource{memory, sizeof(memory), std::pmr::null_memory_resource()};
+        EXPECT_EQ(loop_program_t(1000, depth, step_e::CALLS).execute(&resource), 0) << "depth: " << depth;
+    }
+}
+
+// every kernel, which processor supports, gives the same lanes as scalar one, including tails and overflow
+TEST(Paracl_simd, kernels) {
+    const std::vector<simd_op_e> ops = {simd_op_e::ADD, simd_op_e::SUB, simd_op_e::MUL, simd_op_e::EQ, simd_op_e::NE,
+                                        simd_op_e::LT,  simd_op_e::LE,  simd_op_e::GT,  simd_op_e::GE};
+    const int max = std::numeric_limits<int>::max();
+
+    for (int size = 0; size < 40; ++size) {
+        std::vector<int> lhs(size), rhs(size);
+        for (int i = 0; i < size; ++i) {
+            lhs[i] = (i % 5 == 0) ? max - i : (i * 7919) % 23 - 11;
+            rhs[i] = (i % 3 == 0) ? lhs[i] : (i * 104729) % 17 - 8;
+        }
+
+        for (simd_op_e op : ops)
+            for (auto [l, r] : {std::pair{simd_operand_t{lhs.data()}, simd_operand_t{rhs.data()}},
+                                std::pair{simd_operand_t{lhs.data()}, simd_operand_t{nullptr, 3}},
+                                std::pair{simd_operand_t{nullptr, 0}, simd_operand_t{rhs.data()}}}) {
+                std::vector<int> expected(size);
+                simd_apply(op, l, r, expected, simd_level_e::SCALAR);
+
+                for (simd_level_e level : {simd_level_e::SSE41, simd_level_e::AVX2}) {
+                    if (!is_simd_supported(level))
+                        continue;
+                    std::vector<int> result(size);
+                    simd_apply(op, l, r, result, level);
+                    EXPECT_EQ(result, expected) << "size: " << size << ", op: " << static_cast<int>(op)
+                                                << ", level: " << static_cast<int>(level);
+                }
+            }
+    }
+}
+
 int main(int argc, char** argv) {
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();